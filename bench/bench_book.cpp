@@ -0,0 +1,171 @@
+// Ladder-backed vs map-backed OrderBook on a synthetic drifting-mid flow.
+//
+// usage: msim_bench_book [n_ops]
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "msim/journal.hpp"
+#include "msim/matching_engine.hpp"
+#include "msim/rng.hpp"
+
+namespace {
+
+struct Op {
+  enum Kind : uint8_t { Limit, Market, Cancel } kind{Limit};
+  msim::Order order{};
+};
+
+std::vector<Op> make_flow(std::size_t n, uint64_t seed) {
+  msim::Rng rng(seed);
+  std::vector<Op> ops;
+  ops.reserve(n);
+
+  std::vector<msim::OrderId> live;
+  msim::Price mid = 100'000;
+  msim::OrderId next_id = 1;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto ts = static_cast<msim::Ts>(i);
+    if (rng.uniform01() < 0.01) mid += rng.uniform_int(-3, 3);
+
+    const double u = rng.uniform01();
+    Op op{};
+    if (u < 0.60 || live.empty()) {
+      const auto side = (rng.uniform01() < 0.5) ? msim::Side::Buy : msim::Side::Sell;
+      const msim::Price off = rng.uniform_int(1, 200);
+      const msim::Price px = (side == msim::Side::Buy) ? mid - off : mid + off;
+      op.kind = Op::Limit;
+      op.order = msim::Order{next_id, ts, side, msim::OrderType::Limit, px, rng.uniform_int(1, 20), 1};
+      live.push_back(next_id++);
+    } else if (u < 0.70) {
+      const auto side = (rng.uniform01() < 0.5) ? msim::Side::Buy : msim::Side::Sell;
+      op.kind = Op::Market;
+      op.order = msim::Order{next_id++, ts, side, msim::OrderType::Market, 0, rng.uniform_int(1, 40), 2};
+    } else {
+      const auto k = static_cast<std::size_t>(rng.uniform_int(0, static_cast<int32_t>(live.size() - 1)));
+      op.kind = Op::Cancel;
+      op.order.id = live[k];
+      live[k] = live.back();
+      live.pop_back();
+    }
+    ops.push_back(op);
+  }
+  return ops;
+}
+
+double run(const std::vector<Op>& ops, msim::BookConfig book_cfg, std::size_t& trades,
+           msim::JournalWriter* journal = nullptr) {
+  msim::RulesConfig rcfg{};
+  rcfg.enable_price_bands = false;
+  rcfg.enable_volatility_interruption = false;
+  rcfg.enable_circuit_breaker = false;
+  msim::MatchingEngine eng{msim::RuleSet{rcfg}, book_cfg};
+  eng.set_journal(journal);
+
+  trades = 0;
+  std::vector<msim::Trade> fills;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (const auto& op : ops) {
+    if (op.kind == Op::Cancel) {
+      (void)eng.book_mut().cancel(op.order.id);
+    } else {
+      fills.clear();
+      (void)eng.process(op.order, fills);
+      trades += fills.size();
+    }
+  }
+  if (journal) journal->close();
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(ops.size());
+}
+
+// Sparse book (one level every `gap` ticks), refilled after each market order
+// sweeps `sweep_levels` levels: stresses next-best-level discovery.
+double run_sweeps(msim::BookConfig book_cfg, int sweeps, int sweep_levels, msim::Price gap) {
+  msim::RulesConfig rcfg{};
+  rcfg.enable_price_bands = false;
+  rcfg.enable_volatility_interruption = false;
+  rcfg.enable_circuit_breaker = false;
+  msim::MatchingEngine eng{msim::RuleSet{rcfg}, book_cfg};
+
+  msim::OrderId id = 1;
+  msim::Ts ts = 0;
+  double ns = 0.0;
+  for (int s = 0; s < sweeps; ++s) {
+    for (int k = 0; k < sweep_levels; ++k) {
+      const msim::Price px = 100'000 + static_cast<msim::Price>(k) * gap;
+      (void)eng.process(msim::Order{id++, ts++, msim::Side::Sell, msim::OrderType::Limit, px, 1, 1});
+    }
+    const msim::Order mkt{id++, ts++, msim::Side::Buy, msim::OrderType::Market, 0, sweep_levels, 2};
+    const auto t0 = std::chrono::steady_clock::now();
+    (void)eng.process(mkt);
+    const auto t1 = std::chrono::steady_clock::now();
+    ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+  }
+  return ns / static_cast<double>(sweeps);
+}
+
+// Closing auction with `orders` queued limit orders around 10'000; ms to uncross
+double run_uncross(int orders) {
+  msim::RulesConfig rcfg{};
+  rcfg.enable_price_bands = false;
+  rcfg.enable_volatility_interruption = false;
+  rcfg.enable_circuit_breaker = false;
+  msim::MatchingEngine eng{msim::RuleSet{rcfg}};
+  eng.start_closing_auction(1'000'000);
+
+  msim::Rng rng(5);
+  std::vector<msim::Trade> fills;
+  for (int i = 0; i < orders; ++i) {
+    const auto side = (i & 1) ? msim::Side::Sell : msim::Side::Buy;
+    const msim::Price px = 10'000 + rng.uniform_int(-500, 500);
+    (void)eng.process(msim::Order{static_cast<msim::OrderId>(i + 1), i, side, msim::OrderType::Limit, px,
+                                  rng.uniform_int(1, 20), 1}, fills);
+  }
+  const auto t0 = std::chrono::steady_clock::now();
+  (void)eng.flush(1'000'000, fills);
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t n = (argc >= 2) ? static_cast<std::size_t>(std::stoull(argv[1])) : 2'000'000;
+  const auto ops = make_flow(n, 42);
+
+  std::size_t tr_map = 0;
+  std::size_t tr_ladder = 0;
+  const double ns_map = run(ops, msim::BookConfig{1, 0}, tr_map);
+  const double ns_ladder = run(ops, msim::BookConfig{1, 1024}, tr_ladder);
+
+  std::printf("ops=%zu\n", n);
+  std::printf("map-backed    %8.1f ns/op  trades=%zu\n", ns_map, tr_map);
+  std::printf("ladder(1024)  %8.1f ns/op  trades=%zu\n", ns_ladder, tr_ladder);
+
+  {
+    const auto path = (std::filesystem::temp_directory_path() / "msim_bench.journal").string();
+    msim::JournalWriter journal(path);
+    std::size_t tr_journal = 0;
+    const double ns_journal = run(ops, msim::BookConfig{1, 1024}, tr_journal, &journal);
+    std::printf("ladder+journal%8.1f ns/op  (+%.1f ns/op incl. write-out)\n", ns_journal, ns_journal - ns_ladder);
+    std::filesystem::remove(path);
+  }
+
+  const int sweeps = 20'000;
+  const int levels = 64;
+  const msim::Price gap = 7;
+  std::printf("sweep %d levels, gap %d ticks (ns per sweep)\n", levels, gap);
+  std::printf("map-backed    %8.1f\n", run_sweeps(msim::BookConfig{1, 0}, sweeps, levels, gap));
+  std::printf("ladder(1024)  %8.1f\n", run_sweeps(msim::BookConfig{1, 1024}, sweeps, levels, gap));
+
+  for (int orders : {10'000, 100'000}) {
+    std::printf("auction uncross %6d orders  %8.2f ms\n", orders, run_uncross(orders));
+  }
+
+  return (tr_map == tr_ladder) ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+// Multi-instrument throughput vs number of matching shards.
+//
+// Builds an interleaved command stream over N instruments (independent generated
+// flow per instrument, merged by timestamp) and replays it through an Exchange
+// with 0 (inline), 1, 2, 4, ... shard threads, reporting messages per second and
+// checking every configuration prints the same trades.
+//
+// usage: msim_bench_exchange [instruments] [seconds_per_instrument] [max_shards]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "msim/exchange.hpp"
+#include "msim/order_flow.hpp"
+
+namespace {
+
+std::vector<msim::Command> build_flow(std::size_t instruments, double seconds) {
+  msim::FlowParams p{};
+  p.lambda_limit = 2000.0;
+  p.lambda_market = 200.0;
+  p.lambda_cancel = 800.0;
+
+  std::vector<msim::Command> cmds;
+  for (std::size_t k = 0; k < instruments; ++k) {
+    msim::OrderFlowGenerator gen(1000 + k, p);
+    const auto inst = static_cast<msim::InstrumentId>(k);
+    for (const auto& e : gen.generate(0, seconds)) {
+      std::visit([&](const auto& x) {
+        using T = std::decay_t<decltype(x)>;
+        if constexpr (std::is_same_v<T, msim::AddLimit>) {
+          msim::Order o{x.id, x.ts, x.side, msim::OrderType::Limit, x.price, x.qty, x.owner};
+          o.instrument = inst;
+          cmds.push_back(msim::Command::submit(o));
+        } else if constexpr (std::is_same_v<T, msim::AddMarket>) {
+          msim::Order o{x.id, x.ts, x.side, msim::OrderType::Market, 0, x.qty, x.owner};
+          o.instrument = inst;
+          cmds.push_back(msim::Command::submit(o));
+        } else if constexpr (std::is_same_v<T, msim::Cancel>) {
+          cmds.push_back(msim::Command::cancel(x.id, x.ts, inst));
+        } else {
+          cmds.push_back(msim::Command::modify(x.id, x.new_qty, x.ts, inst));
+        }
+      }, e);
+    }
+  }
+  std::stable_sort(cmds.begin(), cmds.end(), [](const msim::Command& a, const msim::Command& b) {
+    return a.order.ts < b.order.ts;
+  });
+  return cmds;
+}
+
+uint64_t trade_hash(const std::vector<msim::Trade>& trades) {
+  uint64_t h = 1469598103934665603ull;
+  for (const auto& t : trades) {
+    for (uint64_t v : {static_cast<uint64_t>(t.instrument), t.id, static_cast<uint64_t>(t.price),
+                       static_cast<uint64_t>(t.qty), t.maker_order_id}) {
+      h = (h ^ v) * 1099511628211ull;
+    }
+  }
+  return h;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t instruments = (argc >= 2) ? static_cast<std::size_t>(std::stoull(argv[1])) : 64;
+  const double seconds = (argc >= 3) ? std::stod(argv[2]) : 5.0;
+  const std::size_t max_shards = (argc >= 4) ? static_cast<std::size_t>(std::stoull(argv[3]))
+                                             : std::max(1u, std::thread::hardware_concurrency());
+
+  const auto cmds = build_flow(instruments, seconds);
+  std::printf("instruments=%zu commands=%zu\n", instruments, cmds.size());
+
+  uint64_t ref = 0;
+  for (std::size_t shards = 0; shards <= max_shards; shards = (shards == 0) ? 1 : shards * 2) {
+    msim::Exchange ex(msim::ExchangeConfig{shards});
+    for (std::size_t k = 0; k < instruments; ++k) (void)ex.add_instrument();
+    ex.start();
+
+    const auto t0 = std::chrono::steady_clock::now();
+    ex.run(cmds);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    const uint64_t h = trade_hash(ex.merged_trades());
+    if (shards == 0) ref = h;
+    const double s = std::chrono::duration<double>(t1 - t0).count();
+    std::printf("shards=%-3zu %8.2f Mmsg/s  trades-hash=%016llx%s\n", shards,
+                static_cast<double>(cmds.size()) / s / 1e6, static_cast<unsigned long long>(h),
+                h == ref ? "" : "  MISMATCH");
+  }
+  return 0;
+}
@@ -0,0 +1,106 @@
+// FlatOrderMap vs std::unordered_map as the OrderBook locator.
+//
+// Models the book's access pattern: a working set of live orders with ids
+// (owner << 32) | seq, where every step adds one order and cancels a random one.
+//
+// usage: msim_bench_locator [live_orders] [steps]
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "msim/order_index.hpp"
+#include "msim/rng.hpp"
+
+namespace {
+
+struct Loc {
+  uint8_t side{};
+  int32_t price{};
+  uint32_t h{};
+};
+
+struct Workload {
+  std::vector<msim::OrderId> initial;
+  std::vector<msim::OrderId> adds;
+  std::vector<std::size_t> victims; // index into the live set
+};
+
+Workload make_workload(std::size_t live, std::size_t steps, bool sequential_ids) {
+  msim::Rng rng(11);
+  Workload w;
+  std::vector<uint32_t> seq(64, 1);
+  auto next_id = [&]() -> msim::OrderId {
+    if (sequential_ids) return static_cast<msim::OrderId>(seq[0]++);
+    const auto owner = static_cast<std::size_t>(rng.uniform_int(1, 63));
+    return (static_cast<uint64_t>(owner) << 32) | seq[owner]++;
+  };
+  for (std::size_t i = 0; i < live; ++i) w.initial.push_back(next_id());
+  for (std::size_t i = 0; i < steps; ++i) {
+    w.adds.push_back(next_id());
+    w.victims.push_back(static_cast<std::size_t>(rng.uniform_int(0, static_cast<int32_t>(live - 1))));
+  }
+  return w;
+}
+
+using StdMap = std::unordered_map<msim::OrderId, Loc>;
+using FlatMap = msim::FlatOrderMap<Loc>;
+
+void put(StdMap& m, msim::OrderId id, const Loc& l) { m[id] = l; }
+void put(FlatMap& m, msim::OrderId id, const Loc& l) { m.insert_or_assign(id, l); }
+
+const Loc* lookup(const StdMap& m, msim::OrderId id) {
+  auto it = m.find(id);
+  return (it == m.end()) ? nullptr : &it->second;
+}
+const Loc* lookup(const FlatMap& m, msim::OrderId id) { return m.find(id); }
+
+template <class Map>
+double run(Map& m, const Workload& w) {
+  std::vector<msim::OrderId> live = w.initial;
+  for (auto id : live) put(m, id, Loc{0, 1, 2});
+
+  uint64_t sink = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < w.adds.size(); ++i) {
+    put(m, w.adds[i], Loc{1, static_cast<int32_t>(i), 3});
+    auto& victim = live[w.victims[i]];
+    if (const Loc* l = lookup(m, victim)) sink += l->h;
+    m.erase(victim);
+    victim = w.adds[i];
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  if (sink == 42) std::printf(" ");
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(w.adds.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t live = (argc >= 2) ? static_cast<std::size_t>(std::stoull(argv[1])) : 1'000'000;
+  const std::size_t steps = (argc >= 3) ? static_cast<std::size_t>(std::stoull(argv[2])) : 4'000'000;
+
+  std::printf("live=%zu steps=%zu (ns per add+find+cancel)\n", live, steps);
+
+  {
+    const auto w = make_workload(live, steps, false);
+    std::unordered_map<msim::OrderId, Loc> um;
+    FlatMap flat;
+    std::printf("owner<<32|seq ids\n");
+    std::printf("  std::unordered_map  %7.1f\n", run(um, w));
+    std::printf("  FlatOrderMap        %7.1f\n", run(flat, w));
+  }
+  {
+    const auto w = make_workload(live, steps, true);
+    std::unordered_map<msim::OrderId, Loc> um;
+    FlatMap flat;
+    FlatMap dense(live + steps + 1);
+    std::printf("sequential ids\n");
+    std::printf("  std::unordered_map  %7.1f\n", run(um, w));
+    std::printf("  FlatOrderMap        %7.1f\n", run(flat, w));
+    std::printf("  FlatOrderMap dense  %7.1f\n", run(dense, w));
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+// Resting-order memory footprint and level-walk cost, hot/cold split vs full Order.
+//
+// Fills a book with N resting orders and reports bytes per million orders for
+// each layout, then times a front-to-back walk of the level queues (what a
+// sweeping aggressor does) over a pool of full Orders vs compact RestingOrders.
+//
+// usage: msim_bench_memory [orders] [levels]
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "msim/book.hpp"
+#include "msim/order_pool.hpp"
+
+namespace {
+
+template <class T>
+double walk_ns(std::size_t n, std::size_t levels) {
+  msim::SlabPool<T> pool;
+  std::vector<msim::IntrusiveFifo> qs(levels);
+  // Interleave levels so each queue is scattered across slabs, like a live book
+  for (std::size_t i = 0; i < n; ++i) {
+    T v{};
+    v.qty = static_cast<msim::Qty>(1 + i % 7);
+    pool.push_back(qs[i % levels], pool.alloc(v));
+  }
+
+  uint64_t sink = 0;
+  const int reps = 5;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < reps; ++r) {
+    for (const auto& q : qs) {
+      pool.for_each(q, [&](msim::NodeHandle, const T& o) { sink += static_cast<uint64_t>(o.qty); return true; });
+    }
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  if (sink == 42) std::printf(" ");
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(n * reps);
+}
+
+double per_million(std::size_t bytes, std::size_t n) {
+  return static_cast<double>(bytes) * 1e6 / static_cast<double>(n) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t n = (argc >= 2) ? static_cast<std::size_t>(std::stoull(argv[1])) : 1'000'000;
+  const std::size_t levels = (argc >= 3) ? static_cast<std::size_t>(std::stoull(argv[2])) : 512;
+
+  msim::OrderBook book{msim::BookConfig{1, 4096}};
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto k = static_cast<msim::Price>(i % levels);
+    const msim::Side side = (i & 1) ? msim::Side::Sell : msim::Side::Buy;
+    const msim::Price px = (side == msim::Side::Buy) ? 10'000 - k : 10'001 + k;
+    book.add_resting_limit(msim::Order{static_cast<msim::OrderId>(i + 1), 1, side,
+                                       msim::OrderType::Limit, px, 1, 1});
+  }
+  const msim::BookMemory m = book.memory_usage();
+
+  // std::list node: two links + payload, before allocator overhead
+  const std::size_t list_node = sizeof(msim::Order) + 2 * sizeof(void*);
+
+  std::printf("orders=%zu levels=%zu\n", m.live_orders, levels * 2);
+  std::printf("record sizes: Order %zuB, RestingOrder %zuB, RestingCold %zuB\n",
+              sizeof(msim::Order), sizeof(msim::RestingOrder), sizeof(msim::RestingCold));
+  std::printf("MiB per million resting orders (queue storage only)\n");
+  std::printf("  std::list<Order>         %7.1f\n", per_million(list_node * n, n));
+  std::printf("  SlabPool<Order>          %7.1f\n",
+              per_million(sizeof(msim::SlabPool<msim::Order>::Node) * n, n));
+  std::printf("  hot/cold (this book)     %7.1f  (hot %.1f + cold %.1f)\n",
+              per_million(m.order_nodes + m.cold, n), per_million(m.order_nodes, n),
+              per_million(m.cold, n));
+  std::printf("  locator                  %7.1f\n", per_million(m.locator, n));
+
+  std::printf("level walk (ns per order)\n");
+  std::printf("  SlabPool<Order>          %7.2f\n", walk_ns<msim::Order>(n, levels));
+  std::printf("  SlabPool<RestingOrder>   %7.2f\n", walk_ns<msim::RestingOrder>(n, levels));
+  return 0;
+}
@@ -43,7 +43,7 @@ public:
     av.best_bid = view.best_bid;
     av.best_ask = view.best_ask;
     av.mid = view.mid;
-    // av.bid_depth / av.ask_depth remain empty unless World chooses to populate them via make_view()
+    // av.bid_depth() / av.ask_depth() remain empty unless World chooses to populate them via make_view()
 
     // Let the agent generate its native actions
     auto acts = generate_actions(av, rng_);
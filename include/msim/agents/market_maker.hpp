@@ -14,6 +14,9 @@ struct MarketMakerParams {
   Ts    refresh_ns{50'000'000};   // 50ms
   Price max_skew_ticks{20};       // inventory skew clamp
   int64_t skew_per_unit{1};       // ticks per 1 inventory unit
+
+  // Quote GTD orders that lapse at the next refresh instead of cancelling them
+  bool gtd_quotes{false};
 };
 
 class MarketMaker final : public IAgent {
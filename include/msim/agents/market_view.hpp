@@ -1,6 +1,8 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <optional>
-#include <vector>
+#include <span>
 
 #include "msim/book.hpp"
 #include "msim/invariants.hpp"
@@ -15,9 +17,15 @@ struct MarketView {
   std::optional<Price> best_ask;
   std::optional<Price> mid;
 
-  // Optional depth snapshot (keep small for performance)
-  std::vector<LevelSummary> bid_depth;
-  std::vector<LevelSummary> ask_depth;
+  // Optional depth snapshot, copied out of the book's depth image (no allocation;
+  // at most DepthImage::kCapacity levels per side)
+  std::array<LevelSummary, DepthImage::kCapacity> bid_levels{};
+  std::array<LevelSummary, DepthImage::kCapacity> ask_levels{};
+  std::size_t bid_count{0};
+  std::size_t ask_count{0};
+
+  std::span<const LevelSummary> bid_depth() const noexcept { return {bid_levels.data(), bid_count}; }
+  std::span<const LevelSummary> ask_depth() const noexcept { return {ask_levels.data(), ask_count}; }
 };
 
 inline MarketView make_view(const msim::OrderBook& book, Ts ts, std::size_t depth_levels = 0) {
@@ -28,8 +36,9 @@ inline MarketView make_view(const msim::OrderBook& book, Ts ts, std::size_t dept
   v.mid = msim::midprice(v.best_bid, v.best_ask);
 
   if (depth_levels > 0) {
-    v.bid_depth = book.depth(msim::Side::Buy, depth_levels);
-    v.ask_depth = book.depth(msim::Side::Sell, depth_levels);
+    const std::size_t n = std::min(depth_levels, DepthImage::kCapacity);
+    v.bid_count = book.copy_depth(msim::Side::Buy, std::span<LevelSummary>(v.bid_levels).first(n));
+    v.ask_count = book.copy_depth(msim::Side::Sell, std::span<LevelSummary>(v.ask_levels).first(n));
   }
   return v;
 }
@@ -0,0 +1,268 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "msim/level_bitmap.hpp"
+#include "msim/types.hpp"
+
+namespace msim {
+
+// Indicative uncross state of an auction
+struct IndicativeAuction {
+  Price   price{};
+  int64_t matched_qty{0};
+  int64_t imbalance{0};   // demand minus supply at price (> 0: buy surplus)
+};
+
+// Aggregated auction interest, bucketed per tick, maintained incrementally.
+//
+// Demand D(p) (market buys + limit buys priced >= p) is non-increasing in p and
+// supply S(p) (market sells + limit sells priced <= p) is non-decreasing, so the
+// executable volume min(D, S) over candidate prices (prices carrying limit
+// interest) peaks on one contiguous plateau. Fenwick trees over the buckets locate
+// the D/S crossing and the plateau edges by prefix-sum descent, and an occupancy
+// bitmap steps between candidates, so add() and every query are O(log slots).
+//
+// Tie-breaking matches MatchingEngine's historic rule: max volume, then strictly
+// closer to the reference price, then the lowest price.
+//
+// The bucket window grows by doubling to cover new prices. Off-grid prices or a
+// spread wider than max_slots switch the curve to !exact(); callers then fall
+// back to a full pass over their orders until clear().
+class AuctionCurve {
+public:
+  struct Plateau {
+    Price lo{};
+    Price hi{};
+    int64_t volume{0};
+  };
+
+  explicit AuctionCurve(Price tick = 1, std::size_t max_slots = std::size_t{1} << 18)
+    : tick_((tick > 0) ? tick : 1), max_slots_(max_slots) {}
+
+  bool exact() const noexcept { return exact_; }
+
+  void clear() {
+    buy_.clear();
+    sell_.clear();
+    fw_buy_.clear();
+    fw_sell_.clear();
+    fw_cross_.clear();
+    used_.resize(0);
+    mkt_buy_ = mkt_sell_ = limit_buy_ = 0;
+    exact_ = true;
+  }
+
+  // qty may be negative to withdraw interest (e.g. a cancel against a frozen book)
+  void add(Side side, OrderType type, Price px, Qty qty) {
+    if (type == OrderType::Market) {
+      (side == Side::Buy ? mkt_buy_ : mkt_sell_) += qty;
+      return;
+    }
+    if (!exact_) return;
+    if (!cover_(px)) {
+      exact_ = false;
+      return;
+    }
+    const std::size_t i = slot_(px);
+    if (side == Side::Buy) {
+      buy_[i] += qty;
+      limit_buy_ += qty;
+      fw_add_(fw_buy_, i, qty);
+      if (i + 1 < buy_.size()) fw_add_(fw_cross_, i + 1, qty);
+    } else {
+      sell_[i] += qty;
+      fw_add_(fw_sell_, i, qty);
+      fw_add_(fw_cross_, i, qty);
+    }
+    if (buy_[i] != 0 || sell_[i] != 0) used_.set(i);
+    else used_.reset(i);
+  }
+
+  // Demand and supply at px (px need not be a bucket)
+  int64_t demand_at(Price px) const noexcept {
+    if (used_.size() == 0) return mkt_buy_;
+    const int64_t d = static_cast<int64_t>(px) - base_;
+    if (d <= 0) return mkt_buy_ + limit_buy_;
+    const auto k = static_cast<std::size_t>((d + tick_ - 1) / tick_); // first bucket >= px
+    if (k >= buy_.size()) return mkt_buy_;
+    return mkt_buy_ + limit_buy_ - (k == 0 ? 0 : fw_sum_(fw_buy_, k - 1));
+  }
+
+  int64_t supply_at(Price px) const noexcept {
+    if (used_.size() == 0) return mkt_sell_;
+    const int64_t d = static_cast<int64_t>(px) - base_;
+    if (d < 0) return mkt_sell_;
+    const auto k = std::min(static_cast<std::size_t>(d / tick_), sell_.size() - 1);
+    return mkt_sell_ + fw_sum_(fw_sell_, k);
+  }
+
+  // Max-volume price range, or nullopt if nothing is executable
+  std::optional<Plateau> plateau() const noexcept {
+    if (!exact_ || used_.size() == 0 || !used_.any()) return std::nullopt;
+    const std::size_t n = buy_.size();
+
+    // c2: first candidate with S >= D; c1: the candidate before it
+    const int64_t k = mkt_buy_ + limit_buy_ - mkt_sell_;
+    const std::size_t j = fw_lower_bound_(fw_cross_, k);
+    const std::size_t c2 = (j == npos) ? npos : used_.find_next(j);
+    const std::size_t c1 = (c2 == npos) ? used_.find_prev(n - 1)
+                         : (c2 == 0)    ? npos
+                                        : used_.find_prev(c2 - 1);
+
+    int64_t v = 0;
+    if (c1 != npos) v = std::max(v, supply_idx_(c1));
+    if (c2 != npos) v = std::max(v, demand_idx_(c2));
+    if (v <= 0) return std::nullopt;
+
+    // lo: first candidate with S >= v
+    const std::size_t s = fw_lower_bound_(fw_sell_, v - mkt_sell_);
+    const std::size_t lo = used_.find_next(s);
+
+    // hi: last candidate i with limit buys strictly below i <= total demand - v
+    const std::size_t m = fw_lower_bound_(fw_buy_, mkt_buy_ + limit_buy_ - v + 1);
+    const std::size_t hi = used_.find_prev((m == npos) ? n - 1 : m);
+
+    return Plateau{price_at_(lo), price_at_(hi), v};
+  }
+
+  // Resolve the plateau to one price with the reference-price tie-break
+  Price pick(const Plateau& p, std::optional<Price> ref) const noexcept {
+    if (!ref || *ref <= p.lo) return p.lo;
+    if (*ref >= p.hi) return p.hi;
+    const int64_t d = static_cast<int64_t>(*ref) - base_;
+    const auto below = price_at_(used_.find_prev(static_cast<std::size_t>(d / tick_)));
+    const auto above = price_at_(used_.find_next(static_cast<std::size_t>((d + tick_ - 1) / tick_)));
+    const int64_t db = static_cast<int64_t>(*ref) - below;
+    const int64_t da = static_cast<int64_t>(above) - *ref;
+    return (da < db) ? above : below;
+  }
+
+  std::optional<IndicativeAuction> indicative(std::optional<Price> ref) const noexcept {
+    const auto p = plateau();
+    if (!p) return std::nullopt;
+    const Price px = pick(*p, ref);
+    return IndicativeAuction{px, p->volume, demand_at(px) - supply_at(px)};
+  }
+
+private:
+  static constexpr std::size_t npos = LevelBitmap::npos;
+  static constexpr std::size_t kInitialSlots = 1024;
+
+  Price tick_{1};
+  std::size_t max_slots_{0};
+  int64_t base_{0};
+
+  std::vector<int64_t> buy_{};
+  std::vector<int64_t> sell_{};
+  std::vector<int64_t> fw_buy_{};
+  std::vector<int64_t> fw_sell_{};
+  std::vector<int64_t> fw_cross_{};  // sell[i] + buy[i-1]: prefix = S(i) - D(i) + const
+  LevelBitmap used_{};
+
+  int64_t mkt_buy_{0};
+  int64_t mkt_sell_{0};
+  int64_t limit_buy_{0};
+  bool exact_{true};
+
+  Price price_at_(std::size_t i) const noexcept {
+    return static_cast<Price>(base_ + static_cast<int64_t>(i) * tick_);
+  }
+  std::size_t slot_(Price px) const noexcept {
+    return static_cast<std::size_t>((static_cast<int64_t>(px) - base_) / tick_);
+  }
+
+  int64_t supply_idx_(std::size_t i) const noexcept { return mkt_sell_ + fw_sum_(fw_sell_, i); }
+  int64_t demand_idx_(std::size_t i) const noexcept {
+    return mkt_buy_ + limit_buy_ - (i == 0 ? 0 : fw_sum_(fw_buy_, i - 1));
+  }
+
+  // Make px addressable; false if it is off-grid or the window would exceed max_slots
+  bool cover_(Price px) {
+    if (px % tick_ != 0) return false;
+    const int64_t p = px;
+    if (buy_.empty()) {
+      base_ = p - static_cast<int64_t>(kInitialSlots / 2) * tick_;
+      resize_(base_, kInitialSlots);
+      return true;
+    }
+    const int64_t top = base_ + static_cast<int64_t>(buy_.size()) * tick_;
+    if (p >= base_ && p < top) return true;
+
+    const int64_t lo = std::min(base_, p);
+    const int64_t hi = std::max(top, p + tick_);
+    const auto need = static_cast<std::size_t>((hi - lo) / tick_);
+    if (need > max_slots_) return false;
+    std::size_t n = buy_.size();
+    while (n < need) n <<= 1;
+    n = std::min(std::max(n, need), max_slots_);
+
+    // Grow away from the side that overflowed, keeping headroom for further drift
+    const int64_t slack = static_cast<int64_t>(n - need) * tick_;
+    const int64_t new_base = (p < base_) ? lo - slack / 2 / tick_ * tick_ : lo;
+    resize_(new_base, n);
+    return true;
+  }
+
+  void resize_(int64_t new_base, std::size_t n) {
+    std::vector<int64_t> buy(n, 0), sell(n, 0);
+    for (std::size_t i = used_.size() ? used_.find_next(0) : npos; i != npos; i = used_.find_next(i + 1)) {
+      const auto k = static_cast<std::size_t>((price_at_(i) - new_base) / tick_);
+      buy[k] = buy_[i];
+      sell[k] = sell_[i];
+    }
+    base_ = new_base;
+    buy_ = std::move(buy);
+    sell_ = std::move(sell);
+    used_.resize(n);
+    fw_build_(fw_buy_, [&](std::size_t i) { return buy_[i]; });
+    fw_build_(fw_sell_, [&](std::size_t i) { return sell_[i]; });
+    fw_build_(fw_cross_, [&](std::size_t i) { return sell_[i] + (i ? buy_[i - 1] : 0); });
+    for (std::size_t i = 0; i < n; ++i) {
+      if (buy_[i] != 0 || sell_[i] != 0) used_.set(i);
+    }
+  }
+
+  // ---- Fenwick tree (0-based API, 1-based storage) ----
+  template <class F>
+  void fw_build_(std::vector<int64_t>& t, F&& val) {
+    const std::size_t n = buy_.size();
+    t.assign(n + 1, 0);
+    for (std::size_t i = 1; i <= n; ++i) {
+      t[i] += val(i - 1);
+      const std::size_t up = i + (i & (~i + 1));
+      if (up <= n) t[up] += t[i];
+    }
+  }
+
+  static void fw_add_(std::vector<int64_t>& t, std::size_t i, int64_t v) noexcept {
+    for (std::size_t k = i + 1; k < t.size(); k += k & (~k + 1)) t[k] += v;
+  }
+
+  // Sum of [0, i]
+  static int64_t fw_sum_(const std::vector<int64_t>& t, std::size_t i) noexcept {
+    int64_t s = 0;
+    for (std::size_t k = i + 1; k > 0; k &= k - 1) s += t[k];
+    return s;
+  }
+
+  // First index whose prefix sum reaches target (entries are non-negative), or npos
+  static std::size_t fw_lower_bound_(const std::vector<int64_t>& t, int64_t target) noexcept {
+    if (target <= 0) return 0;
+    const std::size_t n = t.size() - 1;
+    std::size_t pos = 0;
+    for (std::size_t step = std::bit_floor(n); step > 0; step >>= 1) {
+      if (pos + step <= n && t[pos + step] < target) {
+        pos += step;
+        target -= t[pos];
+      }
+    }
+    return (pos < n) ? pos : npos;
+  }
+};
+
+} // namespace msim
@@ -1,39 +1,107 @@
 #pragma once
-#include <list>
-#include <map>
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <optional>
-#include <unordered_map>
+#include <span>
 #include <vector>
 
+#include "msim/auction_curve.hpp"
 #include "msim/order.hpp"
 #include "msim/invariants.hpp"
+#include "msim/order_index.hpp"
+#include "msim/order_pool.hpp"
+#include "msim/price_ladder.hpp"
 #include "msim/types.hpp"
 
 namespace msim {
 
 // A lightweight “Level 2” view: price + total quantity + number of resting orders.
+// Quantities are displayed quantities: iceberg reserves are not included.
 struct LevelSummary {
   Price    price{};
   Qty      total_qty{};
   uint32_t order_count{};
 };
 
+// Compact record kept in price-level queues: only what matching touches.
+// Side and price are implied by the level; everything else lives in RestingCold.
+struct RestingOrder {
+  OrderId id{};
+  Ts      ts{};
+  OwnerId owner{};
+  Qty     qty{};     // shown quantity
+  Qty     reserve{}; // iceberg hidden quantity (fills the padding slot)
+};
+static_assert(sizeof(RestingOrder) <= 32, "RestingOrder must stay within half a cache line");
+
+// Rarely-read attributes of a resting order, indexed by the same node handle
+struct RestingCold {
+  TimeInForce tif{TimeInForce::GTC};
+  MarketStyle mkt_style{MarketStyle::PureMarket};
+};
+
+// Bytes held by the book's order storage (capacity, not just live entries)
+struct BookMemory {
+  std::size_t order_nodes{0};
+  std::size_t cold{0};
+  std::size_t locator{0};
+  std::size_t live_orders{0};
+};
+
+// Fixed-capacity top-N depth for one side, maintained in place by the book on
+// every add/cancel/fill. `version` bumps whenever the image changes, so readers can
+// skip work when nothing moved; `dirty` means a bulk update left it to be rebuilt
+// on next read.
+struct DepthImage {
+  static constexpr std::size_t kCapacity = 32;
+
+  std::array<LevelSummary, kCapacity> levels{};
+  uint32_t count{0};
+  uint64_t version{0};
+  bool dirty{false};
+
+  std::span<const LevelSummary> view() const noexcept { return {levels.data(), count}; }
+};
+
+// Price level storage layout
+struct BookConfig {
+  Price tick_size{1};
+
+  // Ticks held in the contiguous ladder window per side (0 = map-backed only)
+  std::size_t ladder_slots{1024};
+
+  // Resting orders to pre-allocate in the node pool (pool still grows on demand)
+  std::size_t reserve_orders{0};
+
+  // Ids below this bypass the locator hash table (direct-indexed); 0 = off
+  std::size_t dense_id_limit{0};
+};
+
 class MatchingEngine; // forward
 
 class OrderBook {
 public:
+  OrderBook() : OrderBook(BookConfig{}) {}
+  explicit OrderBook(BookConfig cfg);
+
+  const BookConfig& config() const noexcept { return cfg_; }
+
   // Insert a *resting* limit order. Returns false if it would cross the spread.
   bool add_resting_limit(Order o);
 
   // O(1) cancel/modify
   bool cancel(OrderId id) noexcept;
 
-  // reduce-only modify
+  // reduce-only modify of total leaves (shown + hidden); trims the reserve first
   bool modify_qty(OrderId id, Qty new_qty) noexcept;
 
   // Backwards-compatible alias (used by older simulator code)
   bool modify(OrderId id, Qty new_qty) noexcept { return modify_qty(id, new_qty); }
 
+  // Hint the locator slot of an upcoming cancel/modify into cache
+  void prefetch_locator(OrderId id) const noexcept { loc_.prefetch(id); }
+
   void erase_locator(OrderId id) noexcept { loc_.erase(id); } // used by engine when it fully fills a maker
 
   // Top of book
@@ -46,35 +114,107 @@ public:
   // L2 depth snapshot: top N levels for a side
   std::vector<LevelSummary> depth(Side side, std::size_t levels) const;
 
+  // Incrementally maintained top-N image (N <= DepthImage::kCapacity)
+  const DepthImage& depth_image(Side side) const;
+
+  // Copy up to out.size() top levels without allocating; returns levels written
+  std::size_t copy_depth(Side side, std::span<LevelSummary> out) const;
+
   // Quick stats
   bool empty(Side side) const noexcept;
   std::size_t level_count(Side side) const noexcept;
+  BookMemory memory_usage() const noexcept;
 
 private:
   friend class MatchingEngine; // engine matches directly against containers
 
-  using Queue = std::list<Order>;
+  // Resting orders live in a per-book slab pool; each level is an intrusive FIFO.
+  // Hot records sit in the pool, cold attributes in a parallel array by handle.
+  using Pool = SlabPool<RestingOrder>;
 
   struct Level {
-    Queue q;
+    IntrusiveFifo q;
     Qty total_qty{0};
   };
 
-  using BidMap = std::map<Price, Level, std::greater<Price>>;
-  using AskMap = std::map<Price, Level, std::less<Price>>;
+  using BidLadder = PriceLadder<Level, Side::Buy>;
+  using AskLadder = PriceLadder<Level, Side::Sell>;
 
-  BidMap bids_;
-  AskMap asks_;
+  BookConfig cfg_{};
+  BidLadder bids_;
+  AskLadder asks_;
+  Pool orders_{};
+  std::vector<RestingCold> cold_{};
 
   struct Locator {
     Side side{};
     Price price{};
-    Queue::iterator it{};
+    NodeHandle h{kNilNode};
   };
 
-  std::unordered_map<OrderId, Locator> loc_;
+  FlatOrderMap<Locator> loc_;
+
+  // Peak size of icebergs that still have a reserve (sparse; read only on refill)
+  FlatOrderMap<Qty> peaks_;
+
+  mutable DepthImage bid_image_{};
+  mutable DepthImage ask_image_{};
+
+  // The engine's auction curve. It lives here, not behind a pointer into the
+  // engine, so copying or moving an engine mid-auction keeps book and curve paired.
+  AuctionCurve auction_curve_{};
+
+  // Set by the engine while the book is frozen into a reopening auction: every
+  // change to resting quantity is mirrored into auction_curve_
+  bool auction_feed_{false};
+
+  void feed_(Side side, Price px, Qty delta) {
+    if (auction_feed_) auction_curve_.add(side, OrderType::Limit, px, delta);
+  }
 
   bool would_cross(const Order& o) const noexcept;
+
+  NodeHandle alloc_resting_(const Order& o, Qty shown, Qty hidden);
+
+  // Refill an iceberg whose shown slice just traded out: the next slice goes to the
+  // tail of the same level under the same node and locator. False if no reserve left.
+  bool replenish_(Level& lvl, Side side, Price px, NodeHandle h, Ts ts) noexcept {
+    RestingOrder& r = orders_[h];
+    if (r.reserve <= 0) return false;
+    const Qty* peak = peaks_.find(r.id);
+    const Qty slice = (peak != nullptr) ? std::min(*peak, r.reserve) : r.reserve;
+    r.reserve -= slice;
+    r.qty = slice;
+    r.ts = ts;
+    if (r.reserve == 0) peaks_.erase(r.id);
+    orders_.unlink(lvl.q, h);
+    orders_.push_back(lvl.q, h);
+    lvl.total_qty += slice;
+    feed_(side, px, slice);
+    return true;
+  }
+
+  // Shown + hidden quantity of a resting order
+  Qty leaves_(NodeHandle h) const noexcept { return orders_[h].qty + orders_[h].reserve; }
+
+  // Unlink a resting order from its level and return its node to the pool
+  void remove_(Level& lvl, NodeHandle h) noexcept {
+    if (orders_[h].reserve > 0) peaks_.erase(orders_[h].id);
+    orders_.unlink(lvl.q, h);
+    orders_.release(h);
+  }
+
+  template <class Ladder>
+  bool cancel_in_(Ladder& side, Price px, NodeHandle h);
+
+  // Reflect the current state of level `px` in the side's depth image
+  void touch_(Side side, Price px) noexcept;
+
+  template <class Ladder>
+  void touch_in_(Ladder& ladder, DepthImage& img, Price px) noexcept;
+
+  template <class Ladder>
+  static void rebuild_(const Ladder& ladder, DepthImage& img) noexcept;
 };
 
 } // namespace msim
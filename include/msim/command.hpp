@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+#include "msim/order.hpp"
+
+namespace msim {
+
+enum class CommandType : uint8_t { Submit = 0, Cancel = 1, Modify = 2 };
+
+// One order-entry message for MatchingEngine::process_batch.
+// Cancel/Modify address the resting order by order.id at order.ts (and
+// order.instrument when routed through an Exchange);
+// Modify is reduce-only and takes the new quantity from order.qty.
+struct Command {
+  CommandType type{CommandType::Submit};
+  Order order{};
+
+  static Command submit(const Order& o) noexcept { return Command{CommandType::Submit, o}; }
+
+  static Command cancel(OrderId id, Ts ts, InstrumentId inst = 0) noexcept {
+    Command c{};
+    c.type = CommandType::Cancel;
+    c.order.id = id;
+    c.order.ts = ts;
+    c.order.instrument = inst;
+    return c;
+  }
+
+  static Command modify(OrderId id, Qty new_qty, Ts ts, InstrumentId inst = 0) noexcept {
+    Command c{};
+    c.type = CommandType::Modify;
+    c.order.id = id;
+    c.order.ts = ts;
+    c.order.qty = new_qty;
+    c.order.instrument = inst;
+    return c;
+  }
+
+  InstrumentId instrument() const noexcept { return order.instrument; }
+};
+
+} // namespace msim
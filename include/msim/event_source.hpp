@@ -0,0 +1,190 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "msim/events.hpp"
+#include "msim/order_flow.hpp"
+
+namespace msim {
+
+// Pull-based stream of events for Simulator::run.
+//
+// A source that promises time order (non-decreasing ts) is consumed lazily in
+// fixed-size chunks and never materialized; any other source is drained and
+// stable-sorted by (ts, arrival order) first, exactly like a vector of events.
+class EventSource {
+public:
+  virtual ~EventSource() = default;
+
+  // Next event; false once the source is exhausted
+  virtual bool next(Event& out) = 0;
+
+  virtual bool time_ordered() const noexcept { return false; }
+};
+
+inline Ts ts_of(const Event& e) noexcept {
+  return std::visit([](const auto& x) { return x.ts; }, e);
+}
+
+// Events already in memory (not owned); time order is checked once up front
+class SpanSource final : public EventSource {
+public:
+  explicit SpanSource(std::span<const Event> events) : events_(events) {
+    for (std::size_t i = 1; i < events_.size() && ordered_; ++i) {
+      ordered_ = ts_of(events_[i - 1]) <= ts_of(events_[i]);
+    }
+  }
+
+  bool next(Event& out) override {
+    if (at_ == events_.size()) return false;
+    out = events_[at_++];
+    return true;
+  }
+  bool time_ordered() const noexcept override { return ordered_; }
+
+private:
+  std::span<const Event> events_;
+  std::size_t at_{0};
+  bool ordered_{true};
+};
+
+// Synthetic order flow produced on demand instead of generate()-ing the horizon
+class GeneratorSource final : public EventSource {
+public:
+  GeneratorSource(uint64_t seed, FlowParams p, Ts t0_ns, double horizon_seconds) : gen_(seed, p) {
+    gen_.start(t0_ns, horizon_seconds);
+  }
+
+  bool next(Event& out) override { return gen_.next(out); }
+  bool time_ordered() const noexcept override { return true; }
+
+private:
+  OrderFlowGenerator gen_;
+};
+
+// K-way merge of time-ordered sources. Equal timestamps go to the source added
+// first, and keep their order within a source, so the merge is deterministic.
+class MergedSource final : public EventSource {
+public:
+  void add(std::unique_ptr<EventSource> s) {
+    ordered_ = ordered_ && s->time_ordered();
+    owned_.push_back(std::move(s));
+    pull_(owned_.size() - 1);
+  }
+
+  bool next(Event& out) override;
+
+  // True only if every input is time-ordered (the merge then is too)
+  bool time_ordered() const noexcept override { return ordered_; }
+
+private:
+  struct Head {
+    Ts ts{};
+    std::size_t src{};
+    Event ev{};
+  };
+
+  std::vector<std::unique_ptr<EventSource>> owned_{};
+  std::vector<Head> heap_{}; // min-heap on (ts, src)
+  bool ordered_{true};
+
+  void pull_(std::size_t src);
+};
+
+// ---------------- Event files ----------------
+//
+// File = EventFileHeader, then fixed 32-byte EventFileRecords in write order.
+// The writer notes in the header whether the timestamps it saw never went
+// backwards, so a reader can stream an ordered file without sorting it.
+
+inline constexpr uint64_t kEventFileMagic = 0x544E'5645'4D49'534Dull; // "MSIMEVNT"
+inline constexpr uint32_t kEventFileVersion = 1;
+inline constexpr uint32_t kEventFileOrdered = 1u << 0;
+
+struct EventFileHeader {
+  uint64_t magic{kEventFileMagic};
+  uint32_t version{kEventFileVersion};
+  uint32_t record_size{0};
+  uint32_t flags{0};
+  uint32_t reserved{0};
+};
+
+struct EventFileRecord {
+  Ts       ts{};
+  OrderId  id{};
+  Price    price{};
+  Qty      qty{};     // new_qty for Modify
+  uint32_t owner{};
+  uint8_t  type{};    // EventType
+  uint8_t  side{};
+  uint8_t  pad[2]{};
+};
+static_assert(sizeof(EventFileRecord) == 32, "EventFileRecord layout changed: bump kEventFileVersion");
+static_assert(std::is_trivially_copyable_v<EventFileRecord>);
+
+// Buffered writer; the header is finalized on close()
+class EventFileWriter {
+public:
+  EventFileWriter() = default;
+  explicit EventFileWriter(const std::string& path) { (void)open(path); }
+  ~EventFileWriter() { close(); }
+
+  EventFileWriter(const EventFileWriter&) = delete;
+  EventFileWriter& operator=(const EventFileWriter&) = delete;
+
+  bool open(const std::string& path);
+  bool is_open() const noexcept { return file_ != nullptr; }
+  bool ok() const noexcept { return ok_; } // false after a failed write
+
+  void write(const Event& e);
+  void close();
+
+private:
+  std::FILE* file_{nullptr};
+  bool ok_{true};
+  std::vector<EventFileRecord> buf_{};
+  std::size_t used_{0};
+  Ts last_ts_{0};
+  bool ordered_{true};
+  bool any_{false};
+
+  void write_out_();
+};
+
+// Streams an event file in fixed-size blocks
+class EventFileReader final : public EventSource {
+public:
+  EventFileReader() = default;
+  explicit EventFileReader(const std::string& path) { (void)open(path); }
+  ~EventFileReader() override { close(); }
+
+  EventFileReader(const EventFileReader&) = delete;
+  EventFileReader& operator=(const EventFileReader&) = delete;
+
+  // False if the file is missing or its header does not match this build
+  bool open(const std::string& path);
+  void close();
+  bool ok() const noexcept { return ok_; } // false after a bad header, read error or torn record
+
+  bool next(Event& out) override;
+  bool time_ordered() const noexcept override { return (flags_ & kEventFileOrdered) != 0; }
+
+private:
+  std::FILE* file_{nullptr};
+  bool ok_{false};
+  bool torn_{false}; // payload is not a whole number of records
+  uint32_t flags_{0};
+  std::vector<EventFileRecord> buf_{};
+  std::size_t used_{0};
+  std::size_t at_{0};
+
+  bool refill_();
+};
+
+} // namespace msim
@@ -11,6 +11,8 @@ struct AddLimit {
   Price   price{};
   Qty     qty{};
   uint32_t owner{};
+
+  friend bool operator==(const AddLimit&, const AddLimit&) = default;
 };
 
 struct AddMarket {
@@ -19,17 +21,23 @@ struct AddMarket {
   Side    side{Side::Buy};
   Qty     qty{};
   uint32_t owner{};
+
+  friend bool operator==(const AddMarket&, const AddMarket&) = default;
 };
 
 struct Cancel {
   OrderId id{};
   Ts      ts{};
+
+  friend bool operator==(const Cancel&, const Cancel&) = default;
 };
 
 struct Modify {
   OrderId id{};
   Ts      ts{};
   Qty     new_qty{};
+
+  friend bool operator==(const Modify&, const Modify&) = default;
 };
 
 using Event = std::variant<AddLimit, AddMarket, Cancel, Modify>;
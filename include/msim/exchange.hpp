@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "msim/command.hpp"
+#include "msim/matching_engine.hpp"
+#include "msim/spsc_queue.hpp"
+
+namespace msim {
+
+inline constexpr InstrumentId kInvalidInstrument = 0xFFFF'FFFFu;
+
+struct ExchangeConfig {
+  // Matching threads; instrument i is owned by shard i % shards.
+  // 0 matches every instrument inline on the submitting thread.
+  std::size_t shards{1};
+
+  // Commands buffered per shard before submit() waits for the shard
+  std::size_t queue_capacity{std::size_t{1} << 16};
+};
+
+// Many instruments, each with its own engine (book, rules, auction state),
+// sharded across matching threads.
+//
+// One producer thread calls submit(); commands reach their shard through a
+// lock-free SPSC queue and each shard applies them to its instruments in
+// arrival order. Instruments never share state, so every instrument sees the
+// same message sequence, and prints the same trades, for any shard count.
+class Exchange {
+public:
+  explicit Exchange(ExchangeConfig cfg = {});
+  ~Exchange();
+
+  Exchange(const Exchange&) = delete;
+  Exchange& operator=(const Exchange&) = delete;
+
+  // Register a symbol (ids are dense from 0). Only before start();
+  // returns kInvalidInstrument once running.
+  InstrumentId add_instrument(RuleSet rules = {}, BookConfig book = {});
+
+  std::size_t instruments() const noexcept { return instruments_.size(); }
+  std::size_t shards() const noexcept { return cfg_.shards; }
+  std::size_t shard_of(InstrumentId id) const noexcept {
+    return cfg_.shards == 0 ? 0 : id % cfg_.shards;
+  }
+
+  void start();
+  void stop(); // drains outstanding commands, then joins the shard threads
+  bool running() const noexcept { return running_; }
+
+  // Route one command by order.instrument (producer thread only). Waits while
+  // the shard queue is full; returns false for an unknown instrument.
+  bool submit(const Command& c);
+
+  // start() if needed, submit everything, drain()
+  void run(std::span<const Command> cmds);
+
+  // Block until every submitted command has been applied
+  void drain();
+
+  // Read access; only consistent after drain() and before the next submit()
+  const MatchingEngine& engine(InstrumentId id) const { return instruments_[id]->engine; }
+  std::span<const Trade> trades(InstrumentId id) const { return instruments_[id]->trades; }
+
+  // Every instrument's trades ordered by (ts, instrument, trade id)
+  std::vector<Trade> merged_trades() const;
+
+private:
+  struct Instrument {
+    MatchingEngine engine;
+    std::vector<Trade> trades{};
+  };
+
+  struct Shard {
+    explicit Shard(std::size_t cap) : queue(cap) {}
+    SpscQueue<Command> queue;
+    std::thread thread{};
+    uint64_t submitted{0}; // producer only
+    alignas(64) std::atomic<uint64_t> applied{0};
+  };
+
+  static constexpr std::size_t kPopBatch = 256;
+
+  ExchangeConfig cfg_{};
+  std::vector<std::unique_ptr<Instrument>> instruments_{};
+  std::vector<std::unique_ptr<Shard>> shards_{};
+  std::atomic<bool> stop_{false};
+  bool running_{false};
+
+  void shard_loop_(Shard& s);
+  void apply_(std::span<const Command> cmds);
+};
+
+} // namespace msim
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "msim/rules.hpp"
+#include "msim/types.hpp"
+
+namespace msim {
+
+enum class ExecType : uint8_t {
+  New = 0,           // order now rests in the book (qty = resting qty)
+  PartialFill = 1,
+  Fill = 2,          // leaves == 0
+  Cancel = 3,        // explicit cancel, reduce-only modify (leaves = new qty) or STP
+  Reject = 4,
+  Expire = 5,        // unfilled IOC/FOK/market remainder dropped by the engine
+  AuctionQueued = 6,
+  StopPending = 7,   // stop parked in the trigger book (price = stop price)
+  Triggered = 8      // stop elected; the order now trades as market/limit
+};
+
+// One event in an order's life, self-describing: consumers need no side tables.
+struct ExecReport {
+  OrderId  order_id{};
+  OwnerId  owner{};
+  Ts       ts{};
+  TradeId  trade_id{};    // fills only
+  Price    price{};       // fill price, else the order's limit price
+  Qty      qty{};         // filled / resting / cancelled / expired quantity
+  Qty      leaves{};      // open quantity after this event
+  InstrumentId instrument{};
+  Side     side{Side::Buy};
+  ExecType type{ExecType::New};
+  RejectReason reason{RejectReason::None}; // Reject, STP cancels
+  bool     maker{false};  // fills: this order was the resting side
+};
+
+// FIFO ring of execution reports owned by the engine and drained by the consumer.
+// When the consumer falls behind the ring doubles instead of overwriting, so no
+// report is lost; once it has grown to the peak burst it never allocates again.
+class ExecRing {
+public:
+  explicit ExecRing(std::size_t capacity = 1024) {
+    std::size_t cap = 16;
+    while (cap < capacity) cap <<= 1;
+    buf_.resize(cap);
+  }
+
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  std::size_t capacity() const noexcept { return buf_.size(); }
+
+  void push(const ExecReport& r) {
+    if (size_ == buf_.size()) grow_();
+    buf_[(head_ + size_) & (buf_.size() - 1)] = r;
+    ++size_;
+  }
+
+  // i-th oldest pending report
+  const ExecReport& operator[](std::size_t i) const noexcept {
+    return buf_[(head_ + i) & (buf_.size() - 1)];
+  }
+
+  // Hand every pending report to f(const ExecReport&) in order, then drop them
+  template <class F>
+  std::size_t drain(F&& f) {
+    const std::size_t n = size_;
+    for (std::size_t i = 0; i < n; ++i) f((*this)[i]);
+    clear();
+    return n;
+  }
+
+  void clear() noexcept {
+    head_ = 0;
+    size_ = 0;
+  }
+
+private:
+  std::vector<ExecReport> buf_{};
+  std::size_t head_{0};
+  std::size_t size_{0};
+
+  void grow_() {
+    std::vector<ExecReport> next(buf_.size() * 2);
+    for (std::size_t i = 0; i < size_; ++i) next[i] = (*this)[i];
+    buf_.swap(next);
+    head_ = 0;
+  }
+};
+
+} // namespace msim
@@ -0,0 +1,188 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "msim/book.hpp"
+#include "msim/command.hpp"
+#include "msim/rules.hpp"
+#include "msim/trade.hpp"
+
+namespace msim {
+
+// ---------------- On-disk format ----------------
+//
+// File = JournalHeader, then fixed 64-byte JournalRecords. Every record has a
+// sequence number (0, 1, 2, ...). Every `checksum_every` records the writer emits
+// a Checksum record whose `a` field hashes all records since the previous
+// checksum (seq included), so a reader can find the last verified prefix after a
+// crash without trusting anything past it. An engine writes its RulesConfig and
+// BookConfig as Config records when the journal is attached, so a replay can
+// rebuild each instrument exactly as it ran.
+
+inline constexpr uint64_t kJournalMagic = 0x4C4E'524A'4D49'534Dull; // "MSIMJRNL"
+inline constexpr uint32_t kJournalVersion = 4;
+
+struct JournalHeader {
+  uint64_t magic{kJournalMagic};
+  uint32_t version{kJournalVersion};
+  uint32_t record_size{0};
+};
+
+enum class JournalKind : uint8_t {
+  Command  = 1, // accepted input: f0 = CommandType, f1 = Side, f2 = packed type/tif/style/peg,
+                //   b = GTD expiry, stop = stop price, display = iceberg peak,
+                //   price = peg offset for pegged orders
+  Reject   = 2, // rejected input (same fields as Command), RejectReason in f1 bits 1..7
+  Fill     = 3, // id = maker, a = taker, b = trade id
+  Phase    = 4, // f0 = new MarketPhase, f1 = previous; ts = end time for session-started phases
+  Checksum = 5, // a = hash of records since the previous checksum, b = their count
+  Config   = 6  // one engine's setup, f0 = JournalConfigPart (see to_config)
+};
+
+enum class JournalConfigPart : uint8_t {
+  Rules = 0, // price = tick, qty = lot, display = min_qty, f1 = StpMode, f2 = flag bits,
+             //   id = band_bps | cb_drop_bps << 32, ts = vol auction, a = cb halt, b = cb reopen
+  Book  = 1  // price = tick, id = ladder_slots, a = reserve_orders, b = dense_id_limit
+};
+
+struct JournalRecord {
+  uint64_t seq{};
+  Ts       ts{};
+  uint64_t id{};   // order id (maker for fills)
+  uint64_t a{};    // owner / taker / checksum
+  uint64_t b{};    // expiry / trade id / checksum span
+  Price    price{};
+  Qty      qty{};
+  InstrumentId instrument{};
+  JournalKind kind{JournalKind::Command};
+  uint8_t  f0{};
+  uint8_t  f1{};
+  uint8_t  f2{};
+  Qty      display{};
+  Price    stop{};
+};
+static_assert(sizeof(JournalRecord) == 64, "JournalRecord layout changed: bump kJournalVersion");
+static_assert(std::is_trivially_copyable_v<JournalRecord>);
+
+// Rolling hash used by the checksum records (one multiply per 8-byte word)
+inline uint64_t journal_hash(uint64_t h, const JournalRecord& r) noexcept {
+  uint64_t w[sizeof(JournalRecord) / 8];
+  static_assert(sizeof(w) == sizeof(JournalRecord));
+  std::memcpy(w, &r, sizeof(r));
+  for (uint64_t x : w) h = (h ^ x) * 0x100'0000'01B3ull;
+  return h;
+}
+inline constexpr uint64_t kJournalHashSeed = 0xCBF2'9CE4'8422'2325ull;
+
+// Rebuild the engine input of a Command/Reject record (exact replay)
+Command to_command(const JournalRecord& r) noexcept;
+
+// Apply a Config record to the part of the setup it carries (the other is left alone)
+void to_config(const JournalRecord& r, RulesConfig& rules, BookConfig& book) noexcept;
+
+// ---------------- Writer ----------------
+
+struct JournalOptions {
+  std::size_t buffer_records{4096}; // records staged in memory per fwrite
+  std::size_t checksum_every{1024};
+};
+
+// Append-only journal. Appends are a copy into a staging buffer plus a rolling
+// hash; the file is only touched when the buffer fills (one sequential fwrite),
+// on flush() and on close. Not thread-safe: one writer per engine.
+class JournalWriter {
+public:
+  JournalWriter() = default;
+  explicit JournalWriter(const std::string& path, JournalOptions opt = {}) { (void)open(path, opt); }
+  ~JournalWriter() { close(); }
+
+  JournalWriter(const JournalWriter&) = delete;
+  JournalWriter& operator=(const JournalWriter&) = delete;
+
+  bool open(const std::string& path, JournalOptions opt = {});
+  bool is_open() const noexcept { return file_ != nullptr; }
+  bool ok() const noexcept { return ok_; } // false after a failed write
+
+  // Seals the tail with a checksum, writes everything out, closes the file
+  void close();
+  void flush();
+
+  uint64_t next_seq() const noexcept { return seq_; }
+
+  void command(const Command& c);
+  void reject(const Command& c, RejectReason why);
+  void fill(const Trade& t);
+  void fills(std::span<const Trade> ts) { for (const auto& t : ts) fill(t); }
+  void phase(Ts ts, MarketPhase from, MarketPhase to);
+  void config(InstrumentId instrument, const RulesConfig& rules, const BookConfig& book);
+
+private:
+  std::FILE* file_{nullptr};
+  bool ok_{true};
+  JournalOptions opt_{};
+
+  std::vector<JournalRecord> buf_{};
+  std::size_t used_{0};
+
+  uint64_t seq_{0};
+  uint64_t hash_{kJournalHashSeed};
+  uint64_t since_check_{0};
+
+  void append_(JournalRecord r);
+  void checksum_();
+  void write_out_();
+};
+
+// ---------------- Reader ----------------
+
+enum class JournalStatus : uint8_t {
+  Ok = 0,          // every record covered by a checksum
+  UnsealedTail,    // trailing records after the last checksum (crash before close)
+  BadChecksum,     // a checksum did not match; records from that block on are dropped
+  SequenceGap,
+  BadHeader,
+  IoError
+};
+
+struct JournalScan {
+  JournalStatus status{JournalStatus::Ok};
+  std::size_t verified{0}; // records in the verified prefix (checksum records included)
+};
+
+// Validate an in-memory (or mapped) record array; recovery replays records[0, verified)
+JournalScan verify_journal(std::span<const JournalRecord> records) noexcept;
+
+// Load a journal file; `out` receives every record that parsed, scan says how many are trusted
+JournalScan read_journal(const std::string& path, std::vector<JournalRecord>& out);
+
+// Read-only, zero-copy view of a journal file: memory-mapped on POSIX systems,
+// read into memory elsewhere. A torn last record is left out of records().
+class MappedJournal {
+public:
+  MappedJournal() = default;
+  explicit MappedJournal(const std::string& path) { (void)open(path); }
+  ~MappedJournal() { close(); }
+
+  MappedJournal(const MappedJournal&) = delete;
+  MappedJournal& operator=(const MappedJournal&) = delete;
+
+  // Ok, IoError or BadHeader
+  JournalStatus open(const std::string& path);
+  void close() noexcept;
+
+  std::span<const JournalRecord> records() const noexcept { return records_; }
+
+private:
+  void* map_{nullptr};
+  std::size_t map_len_{0};
+  std::vector<JournalRecord> loaded_{};
+  std::span<const JournalRecord> records_{};
+};
+
+} // namespace msim
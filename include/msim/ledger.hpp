@@ -11,11 +11,6 @@
 
 namespace msim {
 
-struct OrderMeta {
-  OwnerId owner{};
-  Side side{};
-};
-
 struct Account {
   OwnerId owner{};
   int64_t cash_ticks{0};   // cash measured in "ticks * qty"
@@ -55,32 +50,15 @@ struct AccountSnapshot {
   int64_t mtm_ticks{};
 };
 
-inline void apply_trades_to_accounts(
-    Ts ts,
-    const std::vector<Trade>& trades,
-    const std::unordered_map<OrderId, OrderMeta>& meta,
-    std::unordered_map<OwnerId, Account>& accounts,
-    std::optional<Price> mid_for_mtm) {
-
-  for (const auto& tr : trades) {
-    auto it_m = meta.find(tr.maker_order_id);
-    auto it_t = meta.find(tr.taker_order_id);
-    if (it_m == meta.end() || it_t == meta.end()) continue;
-
-    const auto& mm = it_m->second;
-    const auto& tm = it_t->second;
-
-    auto& am = accounts[mm.owner];
-    am.owner = mm.owner;
-    auto& at = accounts[tm.owner];
-    at.owner = tm.owner;
-
-    am.apply_fill(mm.side, tr.price, tr.qty);
-    at.apply_fill(tm.side, tr.price, tr.qty);
-  }
-
-  (void)ts;
-  (void)mid_for_mtm;
+// Settle fills straight from execution reports: each one names its owner and
+// side, so no per-order metadata has to be kept (or reclaimed) by the caller.
+inline void apply_exec_reports(ExecRing& reports, std::unordered_map<OwnerId, Account>& accounts) {
+  reports.drain([&](const ExecReport& r) {
+    if (r.type != ExecType::Fill && r.type != ExecType::PartialFill) return;
+    auto& a = accounts[r.owner];
+    a.owner = r.owner;
+    a.apply_fill(r.side, r.price, r.qty);
+  });
 }
 
 inline std::vector<AccountSnapshot> make_account_snapshots(
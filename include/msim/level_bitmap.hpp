@@ -0,0 +1,112 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace msim {
+
+// Hierarchical occupancy bitmap over price slots.
+//
+// Layer 0 has one bit per slot; each bit of layer k+1 says whether the matching
+// 64-bit word of layer k is non-zero. Layers are added until the top fits in one
+// word, so next/previous set-bit lookups cost one count-trailing/leading-zeros per
+// layer (2 layers up to 4096 slots, 3 up to 262144) regardless of the gap size.
+class LevelBitmap {
+public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  LevelBitmap() { resize(0); }
+  explicit LevelBitmap(std::size_t bits) { resize(bits); }
+
+  void resize(std::size_t bits) {
+    bits_ = bits;
+    layers_.clear();
+    std::size_t n = bits;
+    do {
+      const std::size_t words = (n + 63) / 64;
+      layers_.emplace_back(words, 0);
+      n = words;
+    } while (n > 1);
+  }
+
+  std::size_t size() const noexcept { return bits_; }
+
+  bool test(std::size_t i) const noexcept {
+    return (layers_[0][i >> 6] >> (i & 63)) & 1u;
+  }
+
+  void set(std::size_t i) noexcept {
+    for (auto& layer : layers_) {
+      uint64_t& w = layer[i >> 6];
+      const bool was_empty = (w == 0);
+      w |= bit_(i);
+      if (!was_empty) return;
+      i >>= 6;
+    }
+  }
+
+  void reset(std::size_t i) noexcept {
+    for (auto& layer : layers_) {
+      uint64_t& w = layer[i >> 6];
+      w &= ~bit_(i);
+      if (w != 0) return;
+      i >>= 6;
+    }
+  }
+
+  bool any() const noexcept { return !layers_.back().empty() && layers_.back()[0] != 0; }
+
+  void clear() noexcept {
+    for (auto& layer : layers_) {
+      for (auto& w : layer) w = 0;
+    }
+  }
+
+  // Smallest set index >= i, or npos
+  std::size_t find_next(std::size_t i) const noexcept { return next_in_(0, i); }
+
+  // Largest set index <= i, or npos
+  std::size_t find_prev(std::size_t i) const noexcept {
+    if (bits_ == 0) return npos;
+    if (i >= bits_) i = bits_ - 1;
+    return prev_in_(0, i);
+  }
+
+private:
+  std::size_t bits_{0};
+  std::vector<std::vector<uint64_t>> layers_{};
+
+  static uint64_t bit_(std::size_t i) noexcept { return uint64_t{1} << (i & 63); }
+
+  std::size_t next_in_(std::size_t k, std::size_t i) const noexcept {
+    const auto& layer = layers_[k];
+    std::size_t w = i >> 6;
+    if (w >= layer.size()) return npos;
+
+    const uint64_t bits = layer[w] & (~uint64_t{0} << (i & 63));
+    if (bits != 0) return (w << 6) + static_cast<std::size_t>(std::countr_zero(bits));
+
+    if (k + 1 == layers_.size()) return npos;
+    w = next_in_(k + 1, w + 1);
+    if (w == npos) return npos;
+    return (w << 6) + static_cast<std::size_t>(std::countr_zero(layer[w]));
+  }
+
+  std::size_t prev_in_(std::size_t k, std::size_t i) const noexcept {
+    const auto& layer = layers_[k];
+    std::size_t w = i >> 6;
+    const std::size_t b = i & 63;
+
+    const uint64_t keep = (b == 63) ? ~uint64_t{0} : ((uint64_t{1} << (b + 1)) - 1);
+    const uint64_t bits = layer[w] & keep;
+    if (bits != 0) return (w << 6) + 63 - static_cast<std::size_t>(std::countl_zero(bits));
+
+    if (w == 0 || k + 1 == layers_.size()) return npos;
+    w = prev_in_(k + 1, w - 1);
+    if (w == npos) return npos;
+    return (w << 6) + 63 - static_cast<std::size_t>(std::countl_zero(layer[w]));
+  }
+};
+
+} // namespace msim
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -33,6 +34,7 @@ struct LiveSnapshot {
   std::optional<Price> best_ask{};
   std::optional<Price> mid{};
   std::optional<Price> last_trade{};
+  std::optional<IndicativeAuction> indicative{};
   std::vector<Trade> recent_trades{};
 };
 
@@ -114,27 +116,13 @@ private:
     }
   }
 
-  template <class Book>
-  static auto depth_levels_(const Book& book, Side side, std::size_t levels) {
-    // Your OrderBook has: depth(Side, size_t)
-    if constexpr (requires { book.depth(side, levels); }) {
-      return book.depth(side, levels);
-    } else if constexpr (requires { book.depth_levels(side, levels); }) {
-      return book.depth_levels(side, levels);
-    } else if constexpr (requires { book.levels(side, levels); }) {
-      return book.levels(side, levels);
-    } else {
-      static_assert(sizeof(Book) == 0, "OrderBook depth API not found (expected depth/depth_levels/levels)");
-    }
-  }
-
-  template <class Book>
-  static std::vector<LiveBookDepth::DepthLevel> extract_depth_(const Book& book, Side side, std::size_t levels) {
-    std::vector<LiveBookDepth::DepthLevel> out;
-    auto lvls = depth_levels_(book, side, levels);
-    out.reserve(lvls.size());
-    for (const auto& x : lvls) out.push_back(to_level_(x));
-    return out;
+  // Refill `out` in place from the book's depth image (no allocation once warm)
+  static void fill_depth_(std::vector<LiveBookDepth::DepthLevel>& out,
+                          const DepthImage& img, std::size_t levels) {
+    out.clear();
+    const auto lvls = img.view();
+    const std::size_t n = std::min(levels, lvls.size());
+    for (std::size_t i = 0; i < n; ++i) out.push_back(to_level_(lvls[i]));
   }
 
   void worker_();
@@ -174,10 +162,13 @@ private:
     std::optional<Price> best_ask{};
     std::optional<Price> mid{};
     std::optional<Price> last_trade{};
+    std::optional<IndicativeAuction> indicative{};
 
     std::deque<Trade> trades;   // recent trades
     std::deque<BookTop> tops;   // mid-series points
     LiveBookDepth depth;        // cached L2 depth
+    uint64_t bid_depth_version{0};
+    uint64_t ask_depth_version{0};
   };
 
   mutable std::mutex cache_mtx_;
@@ -1,10 +1,22 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <optional>
+#include <span>
 #include <vector>
 
+#include "msim/auction_curve.hpp"
 #include "msim/book.hpp"
+#include "msim/command.hpp"
+#include "msim/exec_report.hpp"
+#include "msim/journal.hpp"
 #include "msim/order.hpp"
+#include "msim/peg_book.hpp"
 #include "msim/rules.hpp"
+#include "msim/stop_book.hpp"
+#include "msim/timer_wheel.hpp"
 #include "msim/trade.hpp"
 
 namespace msim {
@@ -20,30 +32,125 @@ struct MatchResult {
   RejectReason reject_reason{RejectReason::None};
 };
 
+// Outcome of one message on the buffer-based path (trades go to the caller's vector)
+struct ProcessStatus {
+  std::optional<Order> resting;
+  Qty filled_qty{0};
+
+  OrderStatus status{OrderStatus::Accepted};
+  RejectReason reject_reason{RejectReason::None};
+};
+
 class MatchingEngine {
 public:
   MatchingEngine() = default;
-  explicit MatchingEngine(RuleSet rules) : rules_(std::move(rules)) {}
+  explicit MatchingEngine(RuleSet rules)
+    : MatchingEngine(std::move(rules), BookConfig{}) {}
+
+  // Ladder tick defaults to the venue tick so every valid price maps to a slot
+  MatchingEngine(RuleSet rules, BookConfig book_cfg)
+    : book_(with_tick_(book_cfg, rules.config().tick_size_ticks)), rules_(std::move(rules)) {}
 
   const OrderBook& book() const noexcept { return book_; }
   OrderBook& book_mut() noexcept { return book_; }
 
+  // Instrument stamped on every trade this engine prints
+  InstrumentId instrument() const noexcept { return instrument_; }
+  void set_instrument(InstrumentId id) noexcept {
+    instrument_ = id;
+    if (journal_) journal_->config(instrument_, rules_.config(), book_.config());
+  }
+
+  // Write-ahead journal of every input, reject, fill and phase change (not owned;
+  // nullptr, the default, costs one branch per message). Attaching records the
+  // engine's rules and book setup first, so the journal replays on its own.
+  void set_journal(JournalWriter* j) noexcept {
+    journal_ = j;
+    if (journal_) journal_->config(instrument_, rules_.config(), book_.config());
+  }
+
+  // Execution reports (off by default): when enabled every rest, fill, cancel,
+  // reject, expiry and auction queueing is pushed to exec_reports() for the
+  // caller to drain
+  void enable_exec_reports(bool on = true) noexcept { reports_on_ = on; }
+  bool exec_reports_enabled() const noexcept { return reports_on_; }
+  ExecRing& exec_reports() noexcept { return exec_; }
+
   const RuleSet& rules() const noexcept { return rules_; }
   RuleSet& rules_mut() noexcept { return rules_; }
 
   void start_trading_at_last(Ts end_ts) noexcept;
   void start_closing_auction(Ts end_ts) noexcept;
 
-  std::vector<Trade> flush(Ts ts);
+  // Session transitions fired by flush() once ts reaches `start`; skipped if ts is
+  // already at or past `end` by then
+  void schedule_trading_at_last(Ts start, Ts end) { arm_(start, TimerKind::TalStart, end); }
+  void schedule_closing_auction(Ts start, Ts end) { arm_(start, TimerKind::CloseStart, end); }
+
+  // Earliest ts at which flush() has anything to do
+  Ts next_deadline() const noexcept { return next_deadline_; }
 
+  std::vector<Trade> flush(Ts ts);
   MatchResult process(Order incoming);
 
+  // Allocation-free variants: trades are appended to `trades` (never cleared), so a
+  // buffer reused across calls stops allocating once it has grown to the peak burst.
+  // flush returns the number of trades appended.
+  std::size_t flush(Ts ts, std::vector<Trade>& trades) {
+    if (ts < next_deadline_) return 0; // nothing due: the per-message fast path
+    return flush_due_(ts, trades);
+  }
+  ProcessStatus process(Order incoming, std::vector<Trade>& trades);
+
+  // Mixed submit/cancel/modify stream, in order. Phase transitions are flushed once
+  // per distinct timestamp (and again if a command moved the phase), locators for
+  // upcoming cancel/modify ids are prefetched, and every fill is appended to
+  // `trades`. on_done(cmd, status, fills) runs after each command; fills covers the
+  // trades appended for it, including any flushed ahead of it. Returns the number
+  // of trades appended. Cancel/modify of an id not resting reports
+  // RejectReason::UnknownOrder; a modify that tries to grow reports InvalidOrder.
+  template <class OnDone>
+  std::size_t process_batch(std::span<const Command> cmds, std::vector<Trade>& trades,
+                            OnDone&& on_done);
+  std::size_t process_batch(std::span<const Command> cmds, std::vector<Trade>& trades) {
+    return process_batch(cmds, trades,
+                         [](const Command&, const ProcessStatus&, std::span<const Trade>) {});
+  }
+
+  // Pending (not yet elected) stop and stop-limit orders
+  const StopBook& stops() const noexcept { return stops_; }
+
+  // Resting pegged orders (non-displayed: not part of book() depth or BBO)
+  const PegBook& pegs() const noexcept { return pegs_; }
+
+  // Price/volume/imbalance the queued auction interest would uncross at right now
+  // (O(log n) while the curve can bucket the queue); nullopt if nothing crosses
+  std::optional<IndicativeAuction> indicative_auction() const;
+
 private:
+  static BookConfig with_tick_(BookConfig cfg, Price tick) noexcept {
+    if (cfg.tick_size <= 1 && tick > 1) cfg.tick_size = tick;
+    return cfg;
+  }
+
   OrderBook book_{};
   RuleSet rules_{};
   TradeId next_trade_id_{1};
+  InstrumentId instrument_{0};
+  JournalWriter* journal_{nullptr};
+  ExecRing exec_{};
+  bool reports_on_{false};
+
+  StopBook stops_{};
+  std::vector<Order> elected_{}; // cascade worklist, reused
+  bool electing_{false};
+
+  TimerWheel expiries_{}; // GTD deadlines; stale timers are skipped when they fire
+
+  PegBook pegs_{};
 
   std::vector<Order> auction_queue_{};
+  bool book_in_auction_{false}; // resting book frozen into a reopening auction
   Ts auction_end_ts_{0};
   Ts tal_end_ts_{0};
 
@@ -52,8 +159,70 @@ private:
   Ts halt_end_ts_{0};
   Ts reopen_auction_end_ts_{0};
 
-  MatchResult process_market(Order incoming);
-  MatchResult process_limit(Order incoming);
+  // Pending transitions as a min-heap on (ts, kind, seq). Start timers act when
+  // they fire; end timers only wake flush(), whose phase checks decide what ends.
+  enum class TimerKind : uint8_t { TalStart, CloseStart, TalEnd, HaltEnd, AuctionEnd };
+  struct EngineTimer {
+    Ts ts{0};
+    TimerKind kind{TimerKind::AuctionEnd};
+    uint32_t seq{0};
+    Ts end{0};
+
+    // Heap order: std::*_heap keep the largest on top, so "later" compares less
+    bool operator<(const EngineTimer& o) const noexcept {
+      if (ts != o.ts) return ts > o.ts;
+      if (kind != o.kind) return kind > o.kind;
+      return seq > o.seq;
+    }
+  };
+  std::vector<EngineTimer> timers_{};
+  uint32_t timer_seq_{0};
+  Ts next_deadline_{std::numeric_limits<Ts>::max()};
+
+  void arm_(Ts at, TimerKind kind, Ts end = 0);
+  std::size_t flush_due_(Ts ts, std::vector<Trade>& trades);
+  void fire_timers_(Ts ts);
+
+  static constexpr std::size_t kBatchPrefetch = 8; // commands ahead
+
+  ProcessStatus process_(Order incoming, std::vector<Trade>& trades, std::size_t first);
+  ProcessStatus apply_(const Command& c, std::vector<Trade>& trades, std::size_t first);
+  void report_(ExecType t, const Order& o, Qty qty, Qty leaves,
+               RejectReason why = RejectReason::None) {
+    if (reports_on_) {
+      exec_.push(ExecReport{o.id, o.owner, o.ts, 0, o.price, qty, leaves, instrument_, o.side, t, why, false});
+    }
+  }
+  ProcessStatus reject_(const Order& o, RejectReason why);
+
+  // stops
+  bool park_stop_(Order& incoming, ProcessStatus& st);
+  void elect_stops_(std::span<const Trade> prints, std::vector<Trade>& trades);
+
+  // GTD expiry
+  void track_expiry_(const Order& o) {
+    if (o.tif != TimeInForce::GTD) return;
+    expiries_.schedule(o.expire_ts, o.id);
+    next_deadline_ = std::min(next_deadline_, o.expire_ts);
+  }
+  void expire_(Ts ts);
+
+  // pegs
+  void add_peg_(const Order& incoming, ProcessStatus& st);
+  template <Side S, StpMode M>
+  bool fill_peg_(std::vector<Trade>& trades, Order& taker, const Order& peg, Price px);
+  void cross_pegs_(Ts ts, std::vector<Trade>& trades);
+  void settle_peg_crosses_(Ts ts, std::vector<Trade>& trades);
+
+  void journal_message_(const Command& c, const ProcessStatus& st,
+                        std::span<const Trade> fills, MarketPhase before);
+  void prefetch_(const Command& c) const noexcept {
+    if (c.type != CommandType::Submit) book_.prefetch_locator(c.order.id);
+  }
+
+  void process_market(Order incoming, std::vector<Trade>& trades, ProcessStatus& st);
+  void process_limit(Order incoming, std::vector<Trade>& trades, ProcessStatus& st);
+  void settle_(std::span<const Trade> fills, ProcessStatus& st);
 
   Qty available_liquidity(const Order& taker) const noexcept;
 
@@ -64,18 +233,70 @@ private:
   bool should_trigger_volatility_auction(const Order& incoming) const noexcept;
 
   // auction
-  MatchResult queue_in_auction(Order incoming);
-  std::vector<Trade> uncross_auction(Ts uncross_ts);
-  std::optional<Price> compute_clearing_price() const noexcept;
-  Qty executable_volume_at(Price px) const noexcept;
+  void queue_in_auction(Order incoming);
+  void uncross_auction(Ts uncross_ts, std::vector<Trade>& trades);
+  std::optional<IndicativeAuction> clear_from_queue_() const;
+
+  // One order's share of an uncross: a frozen-book node, or an auction_queue_ entry
+  struct AuctionFill {
+    OrderId id{};
+    OwnerId owner{};
+    Qty qty{};
+    Qty leaves{}; // order qty left once this allocation is filled
+    Price px{};
+    NodeHandle h{kNilNode};
+    OrderBook::Level* lvl{nullptr}; // the level holding h, for book fills
+    std::size_t queue_idx{0};
+  };
+  template <Side S>
+  void allocate_uncross_(Price clearing_px, int64_t volume, std::vector<AuctionFill>& out);
+  template <Side S>
+  void apply_uncross_(std::span<const AuctionFill> fills, Ts ts);
 
   // circuit breaker
   void maybe_trigger_circuit_breaker(std::span<const Trade> trades);
 
-  void match_buy(MatchResult& out, Order& taker);
-  void match_sell(MatchResult& out, Order& taker);
+  // Matching loop: policy (side, order type, STP mode) is resolved once per message
+  // by match(), so each instantiation of match_ runs without runtime policy branches
+  void match(std::vector<Trade>& trades, Order& taker);
+  template <StpMode M>
+  void match_stp_(std::vector<Trade>& trades, Order& taker);
+  template <Side S, OrderType T, StpMode M>
+  void match_(std::vector<Trade>& trades, Order& taker);
 
   Trade make_trade(Ts ts, Price px, Qty q, OrderId maker, OrderId taker);
 };
 
+template <class OnDone>
+std::size_t MatchingEngine::process_batch(std::span<const Command> cmds,
+                                          std::vector<Trade>& trades, OnDone&& on_done) {
+  const std::size_t start = trades.size();
+  const std::size_t warm = cmds.size() < kBatchPrefetch ? cmds.size() : kBatchPrefetch;
+  for (std::size_t i = 0; i < warm; ++i) prefetch_(cmds[i]);
+
+  bool flushed = false;
+  Ts flushed_ts = 0;
+  MarketPhase flushed_phase = rules_.phase();
+
+  for (std::size_t i = 0; i < cmds.size(); ++i) {
+    if (i + kBatchPrefetch < cmds.size()) prefetch_(cmds[i + kBatchPrefetch]);
+
+    const Command& c = cmds[i];
+    const std::size_t first = trades.size();
+    if (!flushed || c.order.ts != flushed_ts || rules_.phase() != flushed_phase) {
+      (void)flush(c.order.ts, trades);
+      flushed = true;
+      flushed_ts = c.order.ts;
+      flushed_phase = rules_.phase();
+    }
+
+    const std::size_t own = trades.size();
+    const MarketPhase before = rules_.phase();
+    const ProcessStatus st = apply_(c, trades, first);
+    if (journal_) journal_message_(c, st, std::span<const Trade>(trades).subspan(own), before);
+    on_done(c, st, std::span<const Trade>(trades).subspan(first));
+  }
+  return trades.size() - start;
+}
+
 } // namespace msim
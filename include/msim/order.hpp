@@ -5,12 +5,16 @@
 
 namespace msim {
 
-// Step 8: Time-in-force
-enum class TimeInForce : uint8_t { GTC = 0, IOC = 1, FOK = 2 };
+// Step 8: Time-in-force (GTD rests like GTC until Order::expire_ts)
+enum class TimeInForce : uint8_t { GTC = 0, IOC = 1, FOK = 2, GTD = 3 };
 
 // Step 8: Market order handling
 enum class MarketStyle : uint8_t { PureMarket = 0, MarketToLimit = 1 };
 
+// Pegged limit orders track a lit reference instead of a fixed price:
+// Primary = same-side best, Market = opposite best, Mid = midpoint (see PegBook)
+enum class PegType : uint8_t { None = 0, Primary = 1, Mid = 2, Market = 3 };
+
 struct Order {
   OrderId   id{};
   Ts        ts{};
@@ -23,12 +27,39 @@ struct Order {
   // Step 8 additions (defaults preserve old aggregate init usage)
   TimeInForce tif{TimeInForce::GTC};
   MarketStyle mkt_style{MarketStyle::PureMarket};
+
+  // Multi-instrument routing (0 for single-book setups)
+  InstrumentId instrument{0};
+
+  // Stop trigger (0 = not a stop). A Market order with a stop is a stop order,
+  // a Limit order with one is a stop-limit; see StopBook for the trigger rule.
+  Price stop_price{0};
+
+  // Iceberg peak (0 = fully displayed). Only this much of qty is shown at a time;
+  // the rest is a hidden reserve that refills the peak as it trades.
+  Qty display_qty{0};
+
+  // GTD deadline: the order is live for ts < expire_ts (ignored for other tifs)
+  Ts expire_ts{0};
+
+  // Pegged orders: price = reference + peg_offset (price field unused)
+  PegType peg{PegType::None};
+  Price peg_offset{0};
 };
 
 // Validation used by RuleSet and engine
 inline constexpr bool is_valid_order(const Order& o) noexcept {
   if (o.id == 0) return false;
   if (o.qty <= 0) return false;
+  if (o.stop_price < 0) return false;
+  if (o.display_qty < 0) return false;
+  if (o.tif == TimeInForce::GTD && o.expire_ts <= 0) return false;
+
+  if (o.peg != PegType::None) {
+    // Resting-only Limit instructions
+    return o.type == OrderType::Limit && o.stop_price == 0 &&
+           o.tif != TimeInForce::IOC && o.tif != TimeInForce::FOK;
+  }
 
   if (o.type == OrderType::Limit) {
     if (o.price <= 0) return false;
@@ -30,11 +30,22 @@ public:
   // Generate events in [t0, t0 + horizon_seconds)
   std::vector<Event> generate(Ts t0_ns, double horizon_seconds);
 
+  // Lazy form of generate(): start(), then next() until it returns false.
+  // Produces the same events, in time order, one at a time.
+  void start(Ts t0_ns, double horizon_seconds);
+  bool next(Event& out);
+
 private:
   Rng rng_;
   FlowParams p_;
   OrderId next_id_{1};
 
+  Ts t0_{0};
+  double t_{0.0};          // ns since t0
+  double horizon_ns_{0.0};
+  Price ref_mid_{10000};   // 100.00 if tick=0.01
+  bool live_{false};
+
   Side sample_side();
   Qty sample_qty();
   int32_t sample_offset();
@@ -0,0 +1,184 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "msim/types.hpp"
+
+namespace msim {
+
+// Flat open-addressing map OrderId -> V (linear probing, power-of-two capacity).
+//
+// Tuned for our ids, which are (owner << 32) | seq: the two halves are folded
+// before a Fibonacci multiply so consecutive seqs of one owner spread across the
+// table. Erase uses backward-shift deletion, so there are no tombstones and probe
+// lengths do not degrade under add/cancel churn.
+//
+// Optional dense fast path: ids below `dense_limit` (plain sequential ids, e.g. the
+// OrderFlowGenerator or tests) are stored in a direct-indexed array instead.
+template <class V>
+class FlatOrderMap {
+public:
+  FlatOrderMap() = default;
+  explicit FlatOrderMap(std::size_t dense_limit) { set_dense_limit(dense_limit); }
+
+  void set_dense_limit(std::size_t n) {
+    dense_vals_.assign(n, V{});
+    dense_used_.assign(n, 0);
+  }
+
+  std::size_t size() const noexcept { return size_ + dense_size_; }
+  bool empty() const noexcept { return size() == 0; }
+
+  // Bytes held by the table and the dense array
+  std::size_t memory_bytes() const noexcept {
+    return slots_.capacity() * sizeof(Slot) +
+           dense_vals_.capacity() * sizeof(V) + dense_used_.capacity();
+  }
+
+  void reserve(std::size_t n) {
+    std::size_t cap = kMinCapacity;
+    while (cap * kMaxLoadNum < n * kMaxLoadDen) cap <<= 1;
+    if (cap > slots_.size()) rehash_(cap);
+  }
+
+  V* find(OrderId id) noexcept {
+    if (id < dense_vals_.size()) {
+      const auto k = static_cast<std::size_t>(id);
+      return dense_used_[k] ? &dense_vals_[k] : nullptr;
+    }
+    if (slots_.empty()) return nullptr;
+    for (std::size_t i = ideal_(id);; i = (i + 1) & mask_) {
+      Slot& s = slots_[i];
+      if (s.key == id && s.used) return &s.value;
+      if (!s.used) return nullptr;
+    }
+  }
+
+  const V* find(OrderId id) const noexcept { return const_cast<FlatOrderMap*>(this)->find(id); }
+
+  bool contains(OrderId id) const noexcept { return find(id) != nullptr; }
+
+  // Inserts or overwrites; returns true if the key was new
+  bool insert_or_assign(OrderId id, const V& v) {
+    if (id < dense_vals_.size()) {
+      const auto k = static_cast<std::size_t>(id);
+      const bool fresh = !dense_used_[k];
+      dense_vals_[k] = v;
+      dense_used_[k] = 1;
+      if (fresh) ++dense_size_;
+      return fresh;
+    }
+    if ((size_ + 1) * kMaxLoadDen > slots_.size() * kMaxLoadNum) {
+      rehash_(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+    }
+    for (std::size_t i = ideal_(id);; i = (i + 1) & mask_) {
+      Slot& s = slots_[i];
+      if (!s.used) {
+        s.key = id;
+        s.value = v;
+        s.used = 1;
+        ++size_;
+        return true;
+      }
+      if (s.key == id) {
+        s.value = v;
+        return false;
+      }
+    }
+  }
+
+  V& operator[](OrderId id) {
+    if (V* p = find(id)) return *p;
+    insert_or_assign(id, V{});
+    return *find(id);
+  }
+
+  bool erase(OrderId id) noexcept {
+    if (id < dense_vals_.size()) {
+      const auto k = static_cast<std::size_t>(id);
+      if (!dense_used_[k]) return false;
+      dense_used_[k] = 0;
+      --dense_size_;
+      return true;
+    }
+    if (slots_.empty()) return false;
+
+    std::size_t i = ideal_(id);
+    for (;; i = (i + 1) & mask_) {
+      if (!slots_[i].used) return false;
+      if (slots_[i].key == id) break;
+    }
+
+    // Backward-shift: pull later members of the probe run into the hole
+    for (std::size_t j = (i + 1) & mask_;; j = (j + 1) & mask_) {
+      Slot& s = slots_[j];
+      if (!s.used) break;
+      const std::size_t home = ideal_(s.key);
+      if (((j - home) & mask_) >= ((j - i) & mask_)) {
+        slots_[i] = s;
+        i = j;
+      }
+    }
+    slots_[i].used = 0;
+    --size_;
+    return true;
+  }
+
+  void clear() noexcept {
+    for (auto& s : slots_) s.used = 0;
+    for (auto& u : dense_used_) u = 0;
+    size_ = 0;
+    dense_size_ = 0;
+  }
+
+  // Hint the slot an upcoming lookup will touch into cache
+  void prefetch(OrderId id) const noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if (id < dense_vals_.size()) __builtin_prefetch(&dense_vals_[static_cast<std::size_t>(id)]);
+    else if (!slots_.empty()) __builtin_prefetch(&slots_[ideal_(id)]);
+#else
+    (void)id;
+#endif
+  }
+
+private:
+  static constexpr std::size_t kMinCapacity = 16;
+  static constexpr std::size_t kMaxLoadNum = 7; // max load factor 7/10
+  static constexpr std::size_t kMaxLoadDen = 10;
+
+  struct Slot {
+    OrderId key{};
+    V value{};
+    uint8_t used{0};
+  };
+
+  std::vector<Slot> slots_{};
+  std::size_t mask_{0};
+  unsigned shift_{64};
+  std::size_t size_{0};
+
+  std::vector<V> dense_vals_{};
+  std::vector<uint8_t> dense_used_{};
+  std::size_t dense_size_{0};
+
+  std::size_t ideal_(OrderId id) const noexcept {
+    const uint64_t folded = id ^ (id >> 32);
+    return static_cast<std::size_t>((folded * 0x9E37'79B9'7F4A'7C15ull) >> shift_);
+  }
+
+  void rehash_(std::size_t cap) {
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(cap, Slot{});
+    mask_ = cap - 1;
+    shift_ = 64;
+    for (std::size_t c = cap; c > 1; c >>= 1) --shift_;
+    size_ = 0;
+    for (const auto& s : old) {
+      if (s.used) insert_or_assign(s.key, s.value);
+    }
+  }
+};
+
+} // namespace msim
@@ -0,0 +1,148 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace msim {
+
+// Stable handle into a SlabPool (index, not pointer)
+using NodeHandle = uint32_t;
+inline constexpr NodeHandle kNilNode = 0xFFFF'FFFFu;
+
+// Head/tail of an intrusive doubly-linked FIFO whose nodes live in a SlabPool.
+// Trivially copyable, so price levels can be moved around without touching nodes.
+struct IntrusiveFifo {
+  NodeHandle head{kNilNode};
+  NodeHandle tail{kNilNode};
+  uint32_t   count{0};
+
+  bool empty() const noexcept { return count == 0; }
+  std::size_t size() const noexcept { return count; }
+  NodeHandle front() const noexcept { return head; }
+};
+
+// Fixed-size slabs of nodes plus a free list.
+//
+// Slabs are never reallocated, so node addresses stay valid for the life of the
+// pool, and once the pool has warmed up alloc/free never touch the heap.
+template <class T, std::size_t SlabBits = 12>
+class SlabPool {
+public:
+  static constexpr std::size_t kSlabSize = std::size_t{1} << SlabBits;
+
+  struct Node {
+    T value{};
+    NodeHandle prev{kNilNode};
+    NodeHandle next{kNilNode};
+  };
+
+  void reserve(std::size_t n) {
+    while (capacity() < n) grow_();
+  }
+
+  std::size_t capacity() const noexcept { return slabs_.size() * kSlabSize; }
+  std::size_t live() const noexcept { return live_; }
+
+  NodeHandle alloc(const T& v) {
+    if (free_ == kNilNode) grow_();
+    const NodeHandle h = free_;
+    Node& n = node(h);
+    free_ = n.next;
+    n.value = v;
+    n.prev = kNilNode;
+    n.next = kNilNode;
+    ++live_;
+    return h;
+  }
+
+  void release(NodeHandle h) noexcept {
+    Node& n = node(h);
+    n.prev = kNilNode;
+    n.next = free_;
+    free_ = h;
+    --live_;
+  }
+
+  // Drop every node but keep the slabs for reuse
+  void clear() noexcept {
+    free_ = kNilNode;
+    for (std::size_t i = capacity(); i-- > 0;) {
+      Node& n = node(static_cast<NodeHandle>(i));
+      n.prev = kNilNode;
+      n.next = free_;
+      free_ = static_cast<NodeHandle>(i);
+    }
+    live_ = 0;
+  }
+
+  Node& node(NodeHandle h) noexcept {
+    return slabs_[h >> SlabBits][h & (kSlabSize - 1)];
+  }
+  const Node& node(NodeHandle h) const noexcept {
+    return slabs_[h >> SlabBits][h & (kSlabSize - 1)];
+  }
+
+  T& operator[](NodeHandle h) noexcept { return node(h).value; }
+  const T& operator[](NodeHandle h) const noexcept { return node(h).value; }
+
+  // ---- intrusive FIFO operations ----
+  void push_back(IntrusiveFifo& q, NodeHandle h) noexcept {
+    Node& n = node(h);
+    n.prev = q.tail;
+    n.next = kNilNode;
+    if (q.tail != kNilNode) node(q.tail).next = h;
+    else q.head = h;
+    q.tail = h;
+    ++q.count;
+  }
+
+  void unlink(IntrusiveFifo& q, NodeHandle h) noexcept {
+    Node& n = node(h);
+    if (n.prev != kNilNode) node(n.prev).next = n.next;
+    else q.head = n.next;
+    if (n.next != kNilNode) node(n.next).prev = n.prev;
+    else q.tail = n.prev;
+    n.prev = kNilNode;
+    n.next = kNilNode;
+    --q.count;
+  }
+
+  NodeHandle next(NodeHandle h) const noexcept { return node(h).next; }
+
+  // Visit queue front-to-back; f(NodeHandle, T&) returns false to stop
+  template <class F>
+  void for_each(const IntrusiveFifo& q, F&& f) {
+    for (NodeHandle h = q.head; h != kNilNode;) {
+      const NodeHandle nx = node(h).next;
+      if (!f(h, node(h).value)) return;
+      h = nx;
+    }
+  }
+
+  template <class F>
+  void for_each(const IntrusiveFifo& q, F&& f) const {
+    for (NodeHandle h = q.head; h != kNilNode; h = node(h).next) {
+      if (!f(h, node(h).value)) return;
+    }
+  }
+
+private:
+  std::vector<std::unique_ptr<Node[]>> slabs_{};
+  NodeHandle free_{kNilNode};
+  std::size_t live_{0};
+
+  void grow_() {
+    const std::size_t base = capacity();
+    slabs_.push_back(std::make_unique<Node[]>(kSlabSize));
+    // Thread the new slab onto the free list, lowest index first
+    for (std::size_t i = kSlabSize; i-- > 0;) {
+      Node& n = slabs_.back()[i];
+      n.next = free_;
+      free_ = static_cast<NodeHandle>(base + i);
+    }
+  }
+};
+
+} // namespace msim
@@ -0,0 +1,201 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+
+#include "msim/order.hpp"
+#include "msim/order_index.hpp"
+
+namespace msim {
+
+// Non-displayed pegged orders, grouped by side and reference.
+//
+// A peg is stored once, under (side, reference, offset); its price is never
+// written back. Within a group every order shares the reference, so offset order
+// is price order: the group front has its best price, shared with any offsets
+// the passive cap or mid rounding collapse onto it. The effective price is
+// resolved from the lit BBO only when asked for (once per taker, against the BBO
+// it arrived at, or by the peg-vs-peg cross check), so a moving BBO costs nothing
+// per peg.
+//
+// Pegs stay passive against the lit book: a buy is capped one tick under the
+// best ask and a sell floored one tick over the best bid. A peg whose reference
+// side is empty has no price and does not trade.
+class PegBook {
+public:
+  bool empty() const noexcept { return index_.empty(); }
+  bool empty(Side s) const noexcept { return (s == Side::Buy ? buy_count_ : sell_count_) == 0; }
+  std::size_t size() const noexcept { return index_.size(); }
+  bool contains(OrderId id) const noexcept { return index_.contains(id); }
+
+  // Effective price of a peg at the given lit BBO (nullopt if unpriced)
+  static std::optional<Price> price_of(Side side, PegType peg, Price offset, std::optional<Price> bid,
+                                       std::optional<Price> ask, Price tick) noexcept {
+    if (tick <= 0) tick = 1;
+    std::optional<Price> ref;
+    switch (peg) {
+      case PegType::Primary: ref = (side == Side::Buy) ? bid : ask; break;
+      case PegType::Market:  ref = (side == Side::Buy) ? ask : bid; break;
+      case PegType::Mid:
+        if (bid && ask) {
+          const Price twice = *bid + *ask; // round away from the contra side
+          ref = (side == Side::Buy) ? (twice / (2 * tick)) * tick : ((twice + 2 * tick - 1) / (2 * tick)) * tick;
+        }
+        break;
+      case PegType::None: break;
+    }
+    if (!ref) return std::nullopt;
+
+    Price px = *ref + offset;
+    if (side == Side::Buy && ask && px >= *ask) px = *ask - tick;
+    if (side == Side::Sell && bid && px <= *bid) px = *bid + tick;
+    if (px <= 0) return std::nullopt;
+    return px;
+  }
+
+  // False if the id is already resting here
+  bool add(const Order& o) {
+    if (!index_.insert_or_assign(o.id, Loc{o.side, o.peg, o.peg_offset})) return false;
+    if (o.side == Side::Buy) {
+      buys_[slot_(o.peg)][o.peg_offset].push_back(o);
+      ++buy_count_;
+    } else {
+      sells_[slot_(o.peg)][o.peg_offset].push_back(o);
+      ++sell_count_;
+    }
+    return true;
+  }
+
+  // Best priced peg on `side`: best price, then earliest (ts, id) among pegs at it.
+  // The pointer stays valid until the next add/cancel/fill.
+  Order* best(Side side, std::optional<Price> bid, std::optional<Price> ask, Price tick, Price& px) {
+    return (side == Side::Buy) ? best_in_(buys_, bid, ask, tick, px) : best_in_(sells_, bid, ask, tick, px);
+  }
+
+  // Consume q from the order that best() returned (the front of its offset)
+  void fill(const Order& o, Qty q) {
+    if (o.side == Side::Buy) fill_in_(buys_, o, q, buy_count_);
+    else fill_in_(sells_, o, q, sell_count_);
+  }
+
+  // Removes a resting peg; `out` receives it
+  bool cancel(OrderId id, Order& out) {
+    const Loc* l = index_.find(id);
+    if (l == nullptr) return false;
+    const Loc loc = *l;
+    Order* o = find_(id);
+    if (o == nullptr) return false;
+    out = *o;
+    if (loc.side == Side::Buy) erase_(buys_[slot_(loc.peg)], loc.offset, id, buy_count_);
+    else erase_(sells_[slot_(loc.peg)], loc.offset, id, sell_count_);
+    index_.erase(id);
+    return true;
+  }
+
+  // Reduce-only; keeps priority. new_qty <= 0 cancels.
+  bool reduce(OrderId id, Qty new_qty) {
+    Order* o = find_(id);
+    if (o == nullptr || new_qty > o->qty) return false;
+    if (new_qty <= 0) {
+      Order gone{};
+      return cancel(id, gone);
+    }
+    o->qty = new_qty;
+    return true;
+  }
+
+  const Order* find(OrderId id) const noexcept { return const_cast<PegBook*>(this)->find_(id); }
+
+private:
+  struct Loc {
+    Side side{Side::Buy};
+    PegType peg{PegType::None};
+    Price offset{};
+  };
+
+  // Most aggressive offset first: highest for buys, lowest for sells
+  template <class Cmp>
+  using Group = std::map<Price, std::deque<Order>, Cmp>;
+  using BuyGroups = Group<std::greater<Price>>[3];
+  using SellGroups = Group<std::less<Price>>[3];
+
+  BuyGroups buys_{};
+  SellGroups sells_{};
+  std::size_t buy_count_{0};
+  std::size_t sell_count_{0};
+  FlatOrderMap<Loc> index_{};
+
+  static std::size_t slot_(PegType p) noexcept { return static_cast<std::size_t>(p) - 1; }
+
+  template <class Groups>
+  static Order* best_in_(Groups& groups, std::optional<Price> bid, std::optional<Price> ask, Price tick, Price& px) {
+    Order* out = nullptr;
+    for (auto& g : groups) {
+      // The cap and mid rounding can collapse several offsets onto the front's
+      // price; those compete on time, so walk them until the price changes
+      std::optional<Price> front_px;
+      for (auto& [offset, q] : g) {
+        Order& o = q.front();
+        const auto p = price_of(o.side, o.peg, offset, bid, ask, tick);
+        if (!p || (front_px && *p != *front_px)) break;
+        front_px = p;
+        const bool better = (out == nullptr) ||
+                            (o.side == Side::Buy ? *p > px : *p < px) ||
+                            (*p == px && (o.ts < out->ts || (o.ts == out->ts && o.id < out->id)));
+        if (better) {
+          out = &o;
+          px = *p;
+        }
+      }
+    }
+    return out;
+  }
+
+  template <class Groups>
+  void fill_in_(Groups& groups, const Order& o, Qty q, std::size_t& count) {
+    auto& g = groups[slot_(o.peg)];
+    auto it = g.find(o.peg_offset); // best() may pick behind the group front
+    Order& front = it->second.front();
+    front.qty -= q;
+    if (front.qty > 0) return;
+    index_.erase(front.id);
+    it->second.pop_front();
+    if (it->second.empty()) g.erase(it);
+    --count;
+  }
+
+  template <class G>
+  static void erase_(G& g, Price offset, OrderId id, std::size_t& count) {
+    auto it = g.find(offset);
+    if (it == g.end()) return;
+    auto& q = it->second;
+    for (auto o = q.begin(); o != q.end(); ++o) {
+      if (o->id != id) continue;
+      q.erase(o); // keeps FIFO order of the rest
+      if (q.empty()) g.erase(it);
+      --count;
+      return;
+    }
+  }
+
+  Order* find_(OrderId id) noexcept {
+    const Loc* loc = index_.find(id);
+    if (loc == nullptr) return nullptr;
+    return (loc->side == Side::Buy) ? find_in_(buys_[slot_(loc->peg)], loc->offset, id)
+                                    : find_in_(sells_[slot_(loc->peg)], loc->offset, id);
+  }
+
+  template <class G>
+  static Order* find_in_(G& g, Price offset, OrderId id) noexcept {
+    auto it = g.find(offset);
+    if (it == g.end()) return nullptr;
+    for (auto& o : it->second) {
+      if (o.id == id) return &o;
+    }
+    return nullptr;
+  }
+};
+
+} // namespace msim
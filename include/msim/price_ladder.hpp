@@ -0,0 +1,261 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "msim/level_bitmap.hpp"
+#include "msim/types.hpp"
+
+namespace msim {
+
+// One side of the book, keyed by price.
+//
+// Levels inside a window of `slots` ticks live in a contiguous array indexed by
+// (price - base) / tick, so top-of-book and level access are O(1) on the hot path.
+// Prices outside the window (or off the tick grid) spill into an ordered overflow
+// map. The window re-centres on the best price when the market drifts out of it.
+// A hierarchical occupancy bitmap finds the next non-empty slot in a few word ops
+// when the best level empties, however wide the gap.
+//
+// slots == 0 disables the array entirely (pure map-backed side, used as baseline).
+template <class Level, Side S>
+class PriceLadder {
+public:
+  // Better price first: bids descending, asks ascending
+  using Compare = std::conditional_t<S == Side::Buy, std::greater<Price>, std::less<Price>>;
+  using Overflow = std::map<Price, Level, Compare>;
+  static constexpr Side kSide = S;
+
+  PriceLadder() = default;
+  PriceLadder(Price tick, std::size_t slots) { configure(tick, slots); }
+
+  void configure(Price tick, std::size_t slots) {
+    clear();
+    tick_ = (tick > 0) ? tick : 1;
+    slots_.assign(slots, Level{});
+    used_.resize(slots);
+  }
+
+  Price tick() const noexcept { return tick_; }
+  std::size_t window_slots() const noexcept { return slots_.size(); }
+
+  bool empty() const noexcept { return in_window_ == 0 && overflow_.empty(); }
+  std::size_t size() const noexcept { return in_window_ + overflow_.size(); }
+
+  // Best (most aggressive) price on this side
+  std::optional<Price> best_price() const noexcept {
+    if (in_window_ > 0) {
+      const Price wpx = price_at_(best_idx_);
+      if (overflow_.empty() || !better(overflow_.begin()->first, wpx)) return wpx;
+    }
+    if (overflow_.empty()) return std::nullopt;
+    return overflow_.begin()->first;
+  }
+
+  // Best level (nullptr if side is empty); px receives its price
+  Level* best(Price& px) noexcept {
+    if (in_window_ > 0) {
+      const Price wpx = price_at_(best_idx_);
+      if (overflow_.empty() || !better(overflow_.begin()->first, wpx)) {
+        px = wpx;
+        return &slots_[best_idx_];
+      }
+    }
+    if (overflow_.empty()) return nullptr;
+    px = overflow_.begin()->first;
+    return &overflow_.begin()->second;
+  }
+
+  // Best level strictly worse than px (px itself need not be a level)
+  std::optional<Price> next_worse(Price px) const noexcept {
+    std::optional<Price> out;
+    if (in_window_ > 0) {
+      const int64_t d = static_cast<int64_t>(px) - static_cast<int64_t>(base_);
+      std::size_t found = LevelBitmap::npos;
+      if constexpr (S == Side::Buy) {
+        if (d > 0) found = used_.find_prev(static_cast<std::size_t>((d - 1) / tick_));
+      } else {
+        const int64_t from = (d < 0) ? 0 : d / tick_ + 1;
+        found = used_.find_next(static_cast<std::size_t>(from));
+      }
+      if (found != LevelBitmap::npos) out = price_at_(found);
+    }
+    auto it = overflow_.upper_bound(px);
+    if (it != overflow_.end() && (!out || better(it->first, *out))) out = it->first;
+    return out;
+  }
+
+  Level* find(Price px) noexcept {
+    std::size_t i = 0;
+    if (index_of_(px, i)) return used_.test(i) ? &slots_[i] : nullptr;
+    auto it = overflow_.find(px);
+    return (it == overflow_.end()) ? nullptr : &it->second;
+  }
+
+  const Level* find(Price px) const noexcept {
+    return const_cast<PriceLadder*>(this)->find(px);
+  }
+
+  // Returns the level at px, creating an empty one if needed
+  Level& get_or_create(Price px) {
+    std::size_t i = 0;
+    if (!index_of_(px, i) && should_recenter_(px)) {
+      recenter_(px);
+    }
+    if (index_of_(px, i)) {
+      if (!used_.test(i)) {
+        used_.set(i);
+        ++in_window_;
+        if (in_window_ == 1 || better_idx_(i, best_idx_)) best_idx_ = i;
+      }
+      return slots_[i];
+    }
+    return overflow_[px];
+  }
+
+  // Remove the level at px (caller has already drained it)
+  void erase(Price px) {
+    std::size_t i = 0;
+    if (index_of_(px, i)) {
+      if (!used_.test(i)) return;
+      slots_[i] = Level{};
+      used_.reset(i);
+      --in_window_;
+      if (in_window_ > 0 && i == best_idx_) best_idx_ = next_used_(i);
+      if (in_window_ == 0 && !overflow_.empty()) recenter_(overflow_.begin()->first);
+      return;
+    }
+    overflow_.erase(px);
+  }
+
+  void clear() noexcept {
+    for (std::size_t i = used_.find_next(0); i != LevelBitmap::npos; i = used_.find_next(i + 1)) {
+      slots_[i] = Level{};
+    }
+    used_.clear();
+    in_window_ = 0;
+    best_idx_ = 0;
+    overflow_.clear();
+  }
+
+  // Visit levels best-first; f(Price, Level&) returns false to stop
+  template <class F>
+  void for_each(F&& f) {
+    std::size_t i = best_idx_;
+    std::size_t left = in_window_;
+    auto ov = overflow_.begin();
+
+    while (left > 0 || ov != overflow_.end()) {
+      bool take_window = (left > 0);
+      if (take_window && ov != overflow_.end()) take_window = !better(ov->first, price_at_(i));
+
+      if (take_window) {
+        if (!f(price_at_(i), slots_[i])) return;
+        if (--left > 0) i = next_used_(i);
+      } else {
+        if (!f(ov->first, ov->second)) return;
+        ++ov;
+      }
+    }
+  }
+
+  template <class F>
+  void for_each(F&& f) const {
+    const_cast<PriceLadder*>(this)->for_each(
+        [&](Price px, Level& lvl) { return f(px, static_cast<const Level&>(lvl)); });
+  }
+
+  static bool better(Price a, Price b) noexcept { return Compare{}(a, b); }
+
+private:
+  Price tick_{1};
+  Price base_{0};
+  std::vector<Level> slots_{};
+  LevelBitmap used_{};
+  std::size_t in_window_{0};
+  std::size_t best_idx_{0};
+  Overflow overflow_{};
+
+  Price price_at_(std::size_t i) const noexcept {
+    return static_cast<Price>(static_cast<int64_t>(base_) +
+                              static_cast<int64_t>(i) * static_cast<int64_t>(tick_));
+  }
+
+  bool index_of_(Price px, std::size_t& i) const noexcept {
+    if (slots_.empty()) return false;
+    const int64_t d = static_cast<int64_t>(px) - static_cast<int64_t>(base_);
+    if (d < 0 || d % tick_ != 0) return false;
+    const auto k = static_cast<uint64_t>(d / tick_);
+    if (k >= slots_.size()) return false;
+    i = static_cast<std::size_t>(k);
+    return true;
+  }
+
+  // Bids: higher index is better; asks: lower index is better
+  static bool better_idx_(std::size_t a, std::size_t b) noexcept {
+    if constexpr (S == Side::Buy) return a > b;
+    else return a < b;
+  }
+
+  // Next used slot strictly worse than i (caller guarantees one exists)
+  std::size_t next_used_(std::size_t i) const noexcept {
+    if constexpr (S == Side::Buy) return used_.find_prev(i - 1);
+    else return used_.find_next(i + 1);
+  }
+
+  bool should_recenter_(Price px) const noexcept {
+    if (slots_.empty()) return false;
+    if (px % tick_ != 0) return false; // off-grid prices never anchor the window
+    if (in_window_ == 0) return true;
+    // Market drifted past the window edge: follow the new best price
+    return better(px, price_at_(best_idx_));
+  }
+
+  // Move the window so that anchor sits in its middle. O(moved levels).
+  void recenter_(Price anchor) {
+    std::vector<std::pair<Price, Level>> moved;
+    moved.reserve(in_window_);
+    for (std::size_t i = used_.find_next(0); i != LevelBitmap::npos; i = used_.find_next(i + 1)) {
+      moved.emplace_back(price_at_(i), std::move(slots_[i]));
+      slots_[i] = Level{};
+    }
+    used_.clear();
+    in_window_ = 0;
+
+    // Keep base on the tick grid even if the anchor is an off-grid overflow price
+    const int64_t a = static_cast<int64_t>(anchor) - static_cast<int64_t>(anchor % tick_);
+    const int64_t half = static_cast<int64_t>(slots_.size() / 2) * tick_;
+    base_ = static_cast<Price>(a - half);
+
+    for (auto& [px, lvl] : moved) {
+      std::size_t i = 0;
+      if (index_of_(px, i)) place_(i, std::move(lvl));
+      else overflow_.emplace(px, std::move(lvl));
+    }
+
+    // Pull overflow levels that now fall inside the window
+    for (auto it = overflow_.begin(); it != overflow_.end();) {
+      std::size_t i = 0;
+      if (index_of_(it->first, i)) {
+        place_(i, std::move(it->second));
+        it = overflow_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  void place_(std::size_t i, Level&& lvl) {
+    slots_[i] = std::move(lvl);
+    used_.set(i);
+    ++in_window_;
+    if (in_window_ == 1 || better_idx_(i, best_idx_)) best_idx_ = i;
+  }
+};
+
+} // namespace msim
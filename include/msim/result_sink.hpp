@@ -0,0 +1,132 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "msim/command.hpp"
+#include "msim/ledger.hpp"
+#include "msim/rules.hpp"
+#include "msim/trade.hpp"
+
+namespace msim {
+
+struct BookTop {
+  Ts ts{};
+  std::optional<Price> best_bid;
+  std::optional<Price> best_ask;
+  std::optional<Price> mid;
+};
+
+// One rejected order-entry message
+struct RejectRecord {
+  Ts ts{};
+  OrderId id{};
+  OwnerId owner{};
+  CommandType type{CommandType::Submit};
+  RejectReason reason{RejectReason::None};
+};
+
+// Streams a sink asks for; a run skips building anything outside the mask
+inline constexpr unsigned kSinkTrades   = 1u << 0;
+inline constexpr unsigned kSinkTops     = 1u << 1;
+inline constexpr unsigned kSinkRejects  = 1u << 2;
+inline constexpr unsigned kSinkAccounts = 1u << 3;
+inline constexpr unsigned kSinkAll      = kSinkTrades | kSinkTops | kSinkRejects | kSinkAccounts;
+
+// Receives simulation output as it is produced, in event order.
+//
+// Simulator and World hand each trade, top-of-book snapshot, reject and final
+// account snapshot to the sink once and keep nothing themselves, so a run's
+// memory does not grow with its horizon. Spans are only valid for the call.
+class ResultSink {
+public:
+  virtual ~ResultSink() = default;
+
+  virtual unsigned streams() const noexcept { return kSinkAll; }
+
+  virtual void on_trades(std::span<const Trade>) {}
+  virtual void on_top(const BookTop&) {}
+  virtual void on_reject(const RejectRecord&) {}
+  virtual void on_accounts(std::span<const AccountSnapshot>) {}
+
+  // End of run
+  virtual void flush() {}
+};
+
+// Discards everything (and asks for nothing)
+class NullSink final : public ResultSink {
+public:
+  unsigned streams() const noexcept override { return 0; }
+};
+
+// Running totals only: constant memory for any horizon
+class CountingSink : public ResultSink {
+public:
+  uint64_t trades{0};
+  int64_t traded_qty{0};
+  uint64_t tops{0};
+  uint64_t rejects{0};
+  uint64_t cancel_failures{0};
+  uint64_t modify_failures{0};
+  uint64_t accounts{0};
+
+  void on_trades(std::span<const Trade> ts) override {
+    trades += ts.size();
+    for (const auto& t : ts) traded_qty += t.qty;
+  }
+  void on_top(const BookTop&) override { ++tops; }
+  void on_reject(const RejectRecord& r) override {
+    ++rejects;
+    if (r.type == CommandType::Cancel) ++cancel_failures;
+    else if (r.type == CommandType::Modify) ++modify_failures;
+  }
+  void on_accounts(std::span<const AccountSnapshot> as) override { accounts += as.size(); }
+};
+
+// Keeps everything in RAM (what Simulator/World used to return)
+class MemorySink final : public ResultSink {
+public:
+  std::vector<Trade> trades;
+  std::vector<BookTop> tops;
+  std::vector<RejectRecord> rejects;
+  std::vector<AccountSnapshot> accounts;
+
+  void on_trades(std::span<const Trade> ts) override { trades.insert(trades.end(), ts.begin(), ts.end()); }
+  void on_top(const BookTop& t) override { tops.push_back(t); }
+  void on_reject(const RejectRecord& r) override { rejects.push_back(r); }
+  void on_accounts(std::span<const AccountSnapshot> as) override {
+    accounts.insert(accounts.end(), as.begin(), as.end());
+  }
+};
+
+// Writes each requested stream to <prefix>{trades,top,rejects,accounts}.csv as
+// it arrives (and keeps the CountingSink totals).
+class CsvSink final : public CountingSink {
+public:
+  CsvSink() = default;
+  explicit CsvSink(const std::string& prefix, unsigned streams = kSinkAll) { (void)open(prefix, streams); }
+
+  // False if any requested file cannot be created
+  bool open(const std::string& prefix, unsigned streams = kSinkAll);
+  bool ok() const noexcept;
+
+  unsigned streams() const noexcept override { return streams_; }
+
+  void on_trades(std::span<const Trade> ts) override;
+  void on_top(const BookTop& t) override;
+  void on_reject(const RejectRecord& r) override;
+  void on_accounts(std::span<const AccountSnapshot> as) override;
+  void flush() override;
+
+private:
+  unsigned streams_{0};
+  std::ofstream trades_{};
+  std::ofstream tops_{};
+  std::ofstream rejects_{};
+  std::ofstream accounts_{};
+};
+
+} // namespace msim
@@ -0,0 +1,129 @@
+#pragma once
+#include <type_traits>
+
+#include "msim/order.hpp"
+#include "msim/rules.hpp"
+#include "msim/types.hpp"
+
+namespace msim {
+
+// Composable pre-accept checks.
+//
+// A check is a type with
+//   static constexpr bool apply(const Order&, MarketPhase, const RulesConfig&, RuleDecision&) noexcept
+// that returns true to pass, or fills the decision and returns false to reject.
+// RulePipeline<Checks...> runs them left to right and stops at the first reject.
+//
+// Grid checks come in two flavours: compile-time (TickGrid<N>, LotGrid<N>, MinQty<N>),
+// where unit grids vanish and power-of-two grids become a mask, and runtime
+// (RuntimeTick, RuntimeLot, RuntimeMinQty), which read RulesConfig like the
+// original RuleSet did.
+namespace checks {
+
+namespace detail {
+template <class T>
+constexpr bool is_pow2(T n) noexcept { return n > 0 && (n & (n - 1)) == 0; }
+
+template <auto N, class T>
+constexpr bool on_grid(T v) noexcept {
+  if constexpr (N <= 1) return true;
+  else if constexpr (is_pow2(N)) return (v & (N - 1)) == 0;
+  else return (v % N) == 0;
+}
+
+constexpr bool reject(RuleDecision& d, RejectReason why) noexcept {
+  d.accept = false;
+  d.reason = why;
+  return false;
+}
+} // namespace detail
+
+struct PositiveQty {
+  static constexpr bool apply(const Order& o, MarketPhase, const RulesConfig&, RuleDecision& d) noexcept {
+    return o.qty > 0 || detail::reject(d, RejectReason::InvalidOrder);
+  }
+};
+
+// Reject during a halt unless the engine is configured to queue
+struct HaltGate {
+  static constexpr bool apply(const Order&, MarketPhase ph, const RulesConfig& cfg, RuleDecision& d) noexcept {
+    if (ph == MarketPhase::Halted && cfg.enforce_halt && !cfg.queue_orders_during_halt) {
+      return detail::reject(d, RejectReason::MarketHalted);
+    }
+    return true;
+  }
+};
+
+// Tick rule applies to LIMIT orders only (market price is ignored)
+template <Price Tick>
+struct TickGrid {
+  static_assert(Tick > 0, "tick must be positive");
+  static constexpr bool apply(const Order& o, MarketPhase, const RulesConfig&, RuleDecision& d) noexcept {
+    if constexpr (Tick == 1) {
+      return true;
+    } else {
+      if (o.type != OrderType::Limit || detail::on_grid<Tick>(o.price)) return true;
+      return detail::reject(d, RejectReason::PriceNotOnTick);
+    }
+  }
+};
+
+template <Qty Min>
+struct MinQty {
+  static constexpr bool apply(const Order& o, MarketPhase, const RulesConfig&, RuleDecision& d) noexcept {
+    if constexpr (Min <= 1) return true; // PositiveQty already covers qty >= 1
+    else return o.qty >= Min || detail::reject(d, RejectReason::QtyBelowMinimum);
+  }
+};
+
+template <Qty Lot>
+struct LotGrid {
+  static_assert(Lot > 0, "lot must be positive");
+  static constexpr bool apply(const Order& o, MarketPhase, const RulesConfig&, RuleDecision& d) noexcept {
+    return detail::on_grid<Lot>(o.qty) || detail::reject(d, RejectReason::QtyNotOnLot);
+  }
+};
+
+struct RuntimeTick {
+  static constexpr bool apply(const Order& o, MarketPhase, const RulesConfig& cfg, RuleDecision& d) noexcept {
+    if (o.type != OrderType::Limit || cfg.tick_size_ticks <= 0) return true;
+    return (o.price % cfg.tick_size_ticks) == 0 || detail::reject(d, RejectReason::PriceNotOnTick);
+  }
+};
+
+struct RuntimeMinQty {
+  static constexpr bool apply(const Order& o, MarketPhase, const RulesConfig& cfg, RuleDecision& d) noexcept {
+    if (cfg.min_qty <= 0 || o.qty >= cfg.min_qty) return true;
+    return detail::reject(d, RejectReason::QtyBelowMinimum);
+  }
+};
+
+struct RuntimeLot {
+  static constexpr bool apply(const Order& o, MarketPhase, const RulesConfig& cfg, RuleDecision& d) noexcept {
+    if (cfg.lot_size <= 0) return true;
+    return (o.qty % cfg.lot_size) == 0 || detail::reject(d, RejectReason::QtyNotOnLot);
+  }
+};
+
+} // namespace checks
+
+template <class... Checks>
+struct RulePipeline {
+  static constexpr RuleDecision run(const Order& o, MarketPhase ph, const RulesConfig& cfg) noexcept {
+    RuleDecision d{};
+    (void)(Checks::apply(o, ph, cfg, d) && ...);
+    return d;
+  }
+};
+
+// Same checks, same order, as the original RuleSet::pre_accept; grids read RulesConfig
+using RuntimeRulePipeline = RulePipeline<checks::PositiveQty, checks::HaltGate, checks::RuntimeTick,
+                                         checks::RuntimeMinQty, checks::RuntimeLot>;
+
+// Fixed-grid deployment. Keep RulesConfig::tick_size_ticks equal to Tick so the
+// book ladder uses the same grid.
+template <Price Tick, Qty Lot = 1, Qty Min = 1>
+using StaticRulePipeline = RulePipeline<checks::PositiveQty, checks::HaltGate, checks::TickGrid<Tick>,
+                                        checks::MinQty<Min>, checks::LotGrid<Lot>>;
+
+} // namespace msim
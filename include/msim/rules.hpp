@@ -30,7 +30,9 @@ enum class RejectReason : uint8_t {
   SelfTradePrevented,
 
   NoReferencePrice,
-  PriceNotAtLast
+  PriceNotAtLast,
+
+  UnknownOrder // cancel/modify of an id that is not resting
 };
 
 struct RuleDecision {
@@ -69,14 +71,22 @@ struct RulesConfig {
   Ts cb_reopen_auction_duration_ns{5'000'000'000LL};
 };
 
+// Signature of a pre-accept pipeline (see rule_pipeline.hpp)
+using PreAcceptFn = RuleDecision (*)(const Order&, MarketPhase, const RulesConfig&) noexcept;
+
 class RuleSet {
 public:
   RuleSet() = default;
   explicit RuleSet(RulesConfig cfg) : cfg_(cfg) {}
 
-  RuleDecision pre_accept(const Order& incoming) const;
+  RuleDecision pre_accept(const Order& incoming) const { return pre_accept_(incoming, phase_, cfg_); }
   void on_trades(std::span<const Trade> trades);
 
+  // Swap in a compile-time pipeline, e.g. use_pipeline<StaticRulePipeline<4, 100>>()
+  template <class Pipeline>
+  void use_pipeline() noexcept { pre_accept_ = &Pipeline::run; }
+  void use_runtime_pipeline() noexcept { pre_accept_ = &runtime_pre_accept_; }
+
   void set_phase(MarketPhase p) noexcept { phase_ = p; }
   MarketPhase phase() const noexcept { return phase_; }
 
@@ -86,7 +96,10 @@ public:
   std::optional<Price> last_trade_price() const noexcept { return last_trade_price_; }
 
 private:
+  static RuleDecision runtime_pre_accept_(const Order& o, MarketPhase ph, const RulesConfig& cfg) noexcept;
+
   RulesConfig cfg_{};
+  PreAcceptFn pre_accept_{&runtime_pre_accept_};
   MarketPhase phase_{MarketPhase::Continuous};
   std::optional<Price> last_trade_price_{};
 };
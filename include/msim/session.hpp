@@ -16,16 +16,14 @@ public:
   explicit SessionController(SessionSchedule s) : s_(s) {}
 
   void on_time(MatchingEngine& eng, Ts ts) {
-    // Start TAL once
-    if (!tal_started_ && ts >= s_.tal_start_ts && ts < s_.tal_end_ts) {
-      eng.start_trading_at_last(s_.tal_end_ts);
-      tal_started_ = true;
-    }
-
-    // Start closing auction once
-    if (!close_started_ && ts >= s_.closing_auction_start_ts && ts < s_.closing_auction_end_ts) {
-      eng.start_closing_auction(s_.closing_auction_end_ts);
-      close_started_ = true;
+    // Hand the schedule to the engine's timers once; each phase starts at most
+    // once, and only if its window has not already passed
+    if (!armed_) {
+      if (s_.tal_end_ts > s_.tal_start_ts) eng.schedule_trading_at_last(s_.tal_start_ts, s_.tal_end_ts);
+      if (s_.closing_auction_end_ts > s_.closing_auction_start_ts) {
+        eng.schedule_closing_auction(s_.closing_auction_start_ts, s_.closing_auction_end_ts);
+      }
+      armed_ = true;
     }
 
     // Always allow engine to finalize any due auction/close at this timestamp
@@ -34,8 +32,7 @@ public:
 
 private:
   SessionSchedule s_{};
-  bool tal_started_{false};
-  bool close_started_{false};
+  bool armed_{false};
 };
 
 } // namespace msim
@@ -1,20 +1,14 @@
 #pragma once
 #include <cstdint>
-#include <optional>
 #include <vector>
 
+#include "msim/event_source.hpp"
 #include "msim/events.hpp"
 #include "msim/matching_engine.hpp"
+#include "msim/result_sink.hpp"
 
 namespace msim {
 
-struct BookTop {
-  Ts ts{};
-  std::optional<Price> best_bid;
-  std::optional<Price> best_ask;
-  std::optional<Price> mid;
-};
-
 struct SimulationResult {
   std::vector<Trade> trades;
   std::vector<BookTop> tops;        // top-of-book snapshot after each event
@@ -29,11 +23,20 @@ public:
   MatchingEngine& engine_mut() noexcept { return engine_; }
   const MatchingEngine& engine() const noexcept { return engine_; }
 
-  // Deterministic replay: stable ordering by (ts, insertion order)
+  // Deterministic replay: stable ordering by (ts, insertion order). Output
+  // streams into `sink`; nothing is retained here.
+  void run(const std::vector<Event>& events, ResultSink& sink);
+
+  // Pulls events lazily; a time-ordered source is never sorted or materialized
+  void run(EventSource& src, ResultSink& sink);
+
+  // Materialized results (a MemorySink)
   SimulationResult run(const std::vector<Event>& events);
 
 private:
   MatchingEngine engine_;
+
+  void pump_(EventSource& src, ResultSink& sink);
 };
 
 } // namespace msim
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace msim {
+
+// Bounded single-producer/single-consumer ring (power-of-two capacity).
+//
+// Head and tail live on separate cache lines and each side keeps a cached copy
+// of the other's index, so the shared atomics are only re-read when the ring
+// looks full (producer) or empty (consumer).
+template <class T>
+class SpscQueue {
+public:
+  explicit SpscQueue(std::size_t capacity = 1024) {
+    std::size_t cap = 2;
+    while (cap < capacity) cap <<= 1;
+    buf_.resize(cap);
+    mask_ = cap - 1;
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  std::size_t capacity() const noexcept { return buf_.size(); }
+
+  // Producer side
+  bool try_push(const T& v) noexcept {
+    const uint64_t t = tail_.load(std::memory_order_relaxed);
+    if (t - head_cache_ == buf_.size()) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (t - head_cache_ == buf_.size()) return false;
+    }
+    buf_[static_cast<std::size_t>(t) & mask_] = v;
+    tail_.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side: pops up to max items into out, returns how many
+  std::size_t try_pop_bulk(T* out, std::size_t max) noexcept {
+    const uint64_t h = head_.load(std::memory_order_relaxed);
+    if (h == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (h == tail_cache_) return 0;
+    }
+    const uint64_t avail = tail_cache_ - h;
+    const std::size_t n = (avail < max) ? static_cast<std::size_t>(avail) : max;
+    for (std::size_t i = 0; i < n; ++i) out[i] = buf_[static_cast<std::size_t>(h + i) & mask_];
+    head_.store(h + n, std::memory_order_release);
+    return n;
+  }
+
+  bool try_pop(T& out) noexcept { return try_pop_bulk(&out, 1) == 1; }
+
+private:
+  static constexpr std::size_t kLine = 64;
+
+  std::vector<T> buf_{};
+  std::size_t mask_{0};
+
+  alignas(kLine) std::atomic<uint64_t> head_{0}; // next slot to read
+  uint64_t tail_cache_{0};                        // consumer's view of tail_
+
+  alignas(kLine) std::atomic<uint64_t> tail_{0}; // next slot to write
+  uint64_t head_cache_{0};                        // producer's view of head_
+};
+
+} // namespace msim
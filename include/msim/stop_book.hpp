@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "msim/order.hpp"
+#include "msim/order_index.hpp"
+
+namespace msim {
+
+// Pending stop / stop-limit orders, indexed by trigger price per side.
+//
+// A buy stop is elected by a print at or above its stop price, a sell stop by a
+// print at or below it. Each side is a price-sorted map of FIFO buckets ordered
+// nearest-trigger-first, so elect() walks only the crossed buckets: O(log n) to
+// reach the edge plus O(1) per elected order.
+class StopBook {
+public:
+  bool empty() const noexcept { return index_.empty(); }
+  std::size_t size() const noexcept { return index_.size(); }
+  bool contains(OrderId id) const noexcept { return index_.contains(id); }
+
+  // False if the id is already pending
+  bool add(const Order& o) {
+    if (!index_.insert_or_assign(o.id, Loc{o.side, o.stop_price})) return false;
+    if (o.side == Side::Buy) buys_[o.stop_price].push_back(o);
+    else sells_[o.stop_price].push_back(o);
+    return true;
+  }
+
+  // Removes a pending stop; `out` receives it
+  bool cancel(OrderId id, Order& out) {
+    const Loc* loc = index_.find(id);
+    if (loc == nullptr) return false;
+    const bool ok = (loc->side == Side::Buy) ? take_(buys_, loc->stop, id, out)
+                                             : take_(sells_, loc->stop, id, out);
+    index_.erase(id);
+    return ok;
+  }
+
+  // Would a print at px elect this order?
+  static bool crossed(const Order& o, Price px) noexcept {
+    return (o.side == Side::Buy) ? px >= o.stop_price : px <= o.stop_price;
+  }
+
+  // Append every stop crossed by prints spanning [lo, hi]: buy stops (lowest
+  // trigger first) then sell stops (highest first), arrival order within a price
+  void elect(Price lo, Price hi, std::vector<Order>& out) {
+    pop_while_(buys_, [hi](Price stop) { return stop <= hi; }, out);
+    pop_while_(sells_, [lo](Price stop) { return stop >= lo; }, out);
+  }
+
+private:
+  struct Loc {
+    Side side{Side::Buy};
+    Price stop{};
+  };
+
+  using Bucket = std::vector<Order>;
+  std::map<Price, Bucket, std::less<Price>> buys_{};     // nearest trigger = lowest
+  std::map<Price, Bucket, std::greater<Price>> sells_{}; // nearest trigger = highest
+  FlatOrderMap<Loc> index_{};
+
+  template <class Map, class Pred>
+  void pop_while_(Map& m, Pred hit, std::vector<Order>& out) {
+    while (!m.empty() && hit(m.begin()->first)) {
+      for (const auto& o : m.begin()->second) {
+        index_.erase(o.id);
+        out.push_back(o);
+      }
+      m.erase(m.begin());
+    }
+  }
+
+  template <class Map>
+  static bool take_(Map& m, Price stop, OrderId id, Order& out) {
+    auto it = m.find(stop);
+    if (it == m.end()) return false;
+    auto& b = it->second;
+    for (auto o = b.begin(); o != b.end(); ++o) {
+      if (o->id != id) continue;
+      out = *o;
+      b.erase(o); // keeps FIFO order of the rest
+      if (b.empty()) m.erase(it);
+      return true;
+    }
+    return false;
+  }
+};
+
+} // namespace msim
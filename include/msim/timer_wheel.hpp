@@ -0,0 +1,118 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "msim/types.hpp"
+
+namespace msim {
+
+// Hierarchical timing wheel of (deadline, id) timers, one tick per Ts unit.
+//
+// Level k has 64 slots of 64^k ticks each; a timer sits on the lowest level whose
+// slot separates it from the wheel's current time, so 11 levels cover every
+// non-negative Ts without an overflow list. A per-level occupancy word lets
+// advance() jump straight to the next occupied slot, so its cost is the number of
+// timers fired or cascaded, never the number of ticks elapsed. Timers sharing a
+// deadline fire in a deterministic order.
+class TimerWheel {
+public:
+  static constexpr std::size_t kLevels = 11;
+  static constexpr std::size_t kSlots = 64;
+
+  bool empty() const noexcept { return count_ == 0; }
+  std::size_t size() const noexcept { return count_; }
+  Ts now() const noexcept { return static_cast<Ts>(now_); }
+
+  // Lower bound on the earliest pending deadline (exact for level-0 timers);
+  // advance() to anything before it fires nothing. Max Ts when empty.
+  Ts next_due() const noexcept {
+    if (count_ == 0) return std::numeric_limits<Ts>::max();
+    std::size_t k = 0;
+    while (occupied_[k] == 0) ++k;
+    return static_cast<Ts>(slot_start_(k, static_cast<std::size_t>(std::countr_zero(occupied_[k]))));
+  }
+
+  // Deadlines at or before now() fire on the next advance()
+  void schedule(Ts deadline, OrderId id) {
+    place_(Entry{clamp_(deadline), id});
+    ++count_;
+  }
+
+  // Fire every timer with deadline <= t in deadline order: f(id, deadline)
+  template <class F>
+  void advance(Ts t, F&& f) {
+    const uint64_t to = clamp_(t);
+    while (count_ > 0) {
+      std::size_t k = 0;
+      while (occupied_[k] == 0) ++k;
+      const std::size_t s = static_cast<std::size_t>(std::countr_zero(occupied_[k]));
+      const uint64_t start = slot_start_(k, s);
+      if (start > to) break;
+
+      now_ = start;
+      occupied_[k] &= ~(uint64_t{1} << s);
+      std::vector<Entry>& slot = slots_[k][s];
+      scratch_.swap(slot);
+
+      if (k == 0) {
+        count_ -= scratch_.size();
+        for (const auto& e : scratch_) f(e.id, static_cast<Ts>(e.deadline));
+      } else {
+        for (const auto& e : scratch_) place_(e); // cascade one level down (or more)
+      }
+      scratch_.clear();
+      if (slot.empty() && slot.capacity() < scratch_.capacity()) slot.swap(scratch_); // keep the larger buffer
+    }
+    if (to > now_) now_ = to;
+  }
+
+  void clear() noexcept {
+    for (auto& level : slots_) {
+      for (auto& slot : level) slot.clear();
+    }
+    occupied_.fill(0);
+    count_ = 0;
+  }
+
+private:
+  struct Entry {
+    uint64_t deadline{0};
+    OrderId id{0};
+  };
+
+  std::array<std::array<std::vector<Entry>, kSlots>, kLevels> slots_{};
+  std::array<uint64_t, kLevels> occupied_{};
+  std::vector<Entry> scratch_{};
+  uint64_t now_{0};
+  std::size_t count_{0};
+
+  static uint64_t clamp_(Ts t) noexcept { return t < 0 ? 0 : static_cast<uint64_t>(t); }
+
+  // First tick of slot s on level k, within the level's current revolution
+  uint64_t slot_start_(std::size_t k, std::size_t s) const noexcept {
+    const unsigned lo = static_cast<unsigned>(6 * k);
+    const unsigned hi = lo + 6;
+    const uint64_t prefix = (hi >= 64) ? 0 : (now_ >> hi) << hi;
+    return prefix | (static_cast<uint64_t>(s) << lo);
+  }
+
+  void place_(const Entry& e) {
+    std::size_t k = 0;
+    uint64_t d = e.deadline;
+    if (d <= now_) {
+      d = now_; // overdue: due in the current level-0 slot
+    } else {
+      k = static_cast<std::size_t>((63 - std::countl_zero(d ^ now_)) / 6);
+    }
+    const std::size_t s = static_cast<std::size_t>((d >> (6 * k)) & (kSlots - 1));
+    slots_[k][s].push_back(e);
+    occupied_[k] |= uint64_t{1} << s;
+  }
+};
+
+} // namespace msim
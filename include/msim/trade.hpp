@@ -12,6 +12,8 @@ struct Trade {
 
   OrderId  maker_order_id{};
   OrderId  taker_order_id{};
+
+  InstrumentId instrument{0};
 };
 
 inline constexpr bool is_valid_trade(const Trade& t) noexcept {
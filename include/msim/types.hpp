@@ -9,6 +9,7 @@ using Qty      = int32_t;   // shares/contracts
 using OrderId  = uint64_t;
 using TradeId  = uint64_t;
 using OwnerId  = uint64_t;  // <--- ADD THIS
+using InstrumentId = uint32_t; // symbol index within an Exchange
 using Ts       = int64_t;   // timestamp in nanoseconds (or any consistent unit)
 
 enum class Side : uint8_t { Buy = 0, Sell = 1 };
@@ -6,8 +6,8 @@
 #include <vector>
 
 #include "msim/matching_engine.hpp"
-#include "msim/simulator.hpp"   // for BookTop
 #include "msim/ledger.hpp"
+#include "msim/result_sink.hpp"
 
 namespace msim {
 
@@ -17,6 +17,7 @@ struct MarketView {
   std::optional<Price> best_ask{};
   std::optional<Price> mid{};
   std::optional<Price> last_trade{};
+  std::optional<IndicativeAuction> indicative{}; // set while auction interest crosses
 };
 
 struct AgentState {
@@ -79,10 +80,15 @@ struct WorldResult {
 
 class World {
 public:
-  explicit World(MatchingEngine engine) : engine_(std::move(engine)) {}
+  // Accounts are settled from the engine's execution reports
+  explicit World(MatchingEngine engine) : engine_(std::move(engine)) { engine_.enable_exec_reports(); }
 
   void add_agent(std::unique_ptr<IAgent> a) { agents_.push_back(std::move(a)); }
 
+  // Output streams into `sink` step by step; memory does not grow with the horizon
+  void run(uint64_t seed, double horizon_seconds, ResultSink& sink, WorldConfig cfg = {});
+
+  // Materialized results (a MemorySink)
   WorldResult run(uint64_t seed, double horizon_seconds, WorldConfig cfg = {});
 
   MatchingEngine& engine_mut() noexcept { return engine_; }
@@ -94,7 +100,6 @@ private:
   MatchingEngine engine_;
   std::vector<std::unique_ptr<IAgent>> agents_;
 
-  std::unordered_map<OrderId, OrderMeta> order_meta_;
   std::unordered_map<OwnerId, Account> accounts_;
 };
 
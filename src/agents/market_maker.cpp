@@ -26,9 +26,13 @@ void MarketMaker::step(Ts ts, const MarketView& view, const AgentState& self, st
   if (ts < next_refresh_ts_) return;
   next_refresh_ts_ = ts + p_.refresh_ns;
 
-  // cancel old quotes (if any)
-  if (bid_id_ != 0) out.push_back(Action::cancel(bid_id_));
-  if (ask_id_ != 0) out.push_back(Action::cancel(ask_id_));
+  // cancel old quotes (if any); GTD quotes expire in the engine on their own
+  if (!p_.gtd_quotes) {
+    if (bid_id_ != 0) out.push_back(Action::cancel(bid_id_));
+    if (ask_id_ != 0) out.push_back(Action::cancel(ask_id_));
+  }
+  const TimeInForce tif = p_.gtd_quotes ? TimeInForce::GTD : TimeInForce::GTC;
+  const Ts expire_ts = p_.gtd_quotes ? next_refresh_ts_ : 0;
 
   const Price ref = view.mid.value_or(view.last_trade.value_or(100 * tick));
 
@@ -66,7 +70,8 @@ void MarketMaker::step(Ts ts, const MarketView& view, const AgentState& self, st
     b.price = bid_px;
     b.qty = q;
     b.owner = owner_;
-    b.tif = TimeInForce::GTC;
+    b.tif = tif;
+    b.expire_ts = expire_ts;
 
     bid_id_ = b.id;
     out.push_back(Action::submit(b));
@@ -80,7 +85,8 @@ void MarketMaker::step(Ts ts, const MarketView& view, const AgentState& self, st
     a.price = ask_px;
     a.qty = q;
     a.owner = owner_;
-    a.tif = TimeInForce::GTC;
+    a.tif = tif;
+    a.expire_ts = expire_ts;
 
     ask_id_ = a.id;
     out.push_back(Action::submit(a));
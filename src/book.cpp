@@ -13,97 +13,175 @@ bool OrderBook::would_cross(const Order& o) const noexcept {
   }
 }
 
+OrderBook::OrderBook(BookConfig cfg)
+  : cfg_(cfg),
+    bids_(cfg.tick_size, cfg.ladder_slots),
+    asks_(cfg.tick_size, cfg.ladder_slots),
+    auction_curve_(cfg.tick_size) {
+  orders_.reserve(cfg.reserve_orders);
+  cold_.resize(orders_.capacity());
+  loc_.set_dense_limit(cfg.dense_id_limit);
+  loc_.reserve(cfg.reserve_orders);
+}
+
+NodeHandle OrderBook::alloc_resting_(const Order& o, Qty shown, Qty hidden) {
+  const NodeHandle h = orders_.alloc(RestingOrder{o.id, o.ts, o.owner, shown, hidden});
+  if (cold_.size() < orders_.capacity()) cold_.resize(orders_.capacity());
+  cold_[h] = RestingCold{o.tif, o.mkt_style};
+  if (hidden > 0) peaks_.insert_or_assign(o.id, shown);
+  return h;
+}
+
 bool OrderBook::add_resting_limit(Order o) {
   if (o.type != OrderType::Limit) return false;
   if (o.qty <= 0) return false;
   if (would_cross(o)) return false;
 
+  // Icebergs show one peak; the remainder rests hidden behind it
+  const Qty shown = (o.display_qty > 0 && o.display_qty < o.qty) ? o.display_qty : o.qty;
+  const Qty hidden = o.qty - shown;
+
   if (o.side == Side::Buy) {
-    auto& lvl = bids_[o.price];
-    lvl.q.push_back(o);
-    auto it = std::prev(lvl.q.end());
-    lvl.total_qty += o.qty;
-    loc_[o.id] = Locator{Side::Buy, o.price, it};
+    auto& lvl = bids_.get_or_create(o.price);
+    const NodeHandle h = alloc_resting_(o, shown, hidden);
+    orders_.push_back(lvl.q, h);
+    lvl.total_qty += shown;
+    loc_.insert_or_assign(o.id, Locator{Side::Buy, o.price, h});
   } else {
-    auto& lvl = asks_[o.price];
-    lvl.q.push_back(o);
-    auto it = std::prev(lvl.q.end());
-    lvl.total_qty += o.qty;
-    loc_[o.id] = Locator{Side::Sell, o.price, it};
+    auto& lvl = asks_.get_or_create(o.price);
+    const NodeHandle h = alloc_resting_(o, shown, hidden);
+    orders_.push_back(lvl.q, h);
+    lvl.total_qty += shown;
+    loc_.insert_or_assign(o.id, Locator{Side::Sell, o.price, h});
   }
 
+  feed_(o.side, o.price, shown);
+  touch_(o.side, o.price);
   return true;
 }
 
-bool OrderBook::cancel(OrderId id) noexcept {
-  auto it = loc_.find(id);
-  if (it == loc_.end()) return false;
+template <class Ladder>
+bool OrderBook::cancel_in_(Ladder& side, Price px, NodeHandle h) {
+  auto* lvl = side.find(px);
+  if (lvl == nullptr) return false;
 
-  const Locator loc = it->second;
+  feed_(Ladder::kSide, px, -orders_[h].qty);
+  lvl->total_qty -= orders_[h].qty;
+  remove_(*lvl, h);
 
-  if (loc.side == Side::Buy) {
-    auto lvl_it = bids_.find(loc.price);
-    if (lvl_it == bids_.end()) { loc_.erase(it); return false; }
-    auto& lvl = lvl_it->second;
+  if (lvl->q.empty()) side.erase(px);
+  return true;
+}
+
+template <class Ladder>
+void OrderBook::touch_in_(Ladder& ladder, DepthImage& img, Price px) noexcept {
+  if (img.dirty) return; // rebuilt wholesale on next read
+
+  const Level* lvl = ladder.find(px);
+  const bool live = (lvl != nullptr && !lvl->q.empty());
+
+  uint32_t pos = 0;
+  while (pos < img.count && img.levels[pos].price != px) ++pos;
+
+  if (pos < img.count) {
+    if (live) {
+      img.levels[pos].total_qty = lvl->total_qty;
+      img.levels[pos].order_count = static_cast<uint32_t>(lvl->q.size());
+    } else {
+      // Level gone: close the gap and pull the next level up from the book
+      const bool was_full = (img.count == DepthImage::kCapacity);
+      for (uint32_t i = pos + 1; i < img.count; ++i) img.levels[i - 1] = img.levels[i];
+      --img.count;
+      if (was_full) {
+        const auto nx = ladder.next_worse(img.levels[img.count - 1].price);
+        if (const Level* n = nx ? ladder.find(*nx) : nullptr) {
+          img.levels[img.count++] = LevelSummary{*nx, n->total_qty, static_cast<uint32_t>(n->q.size())};
+        }
+      }
+    }
+    ++img.version;
+    return;
+  }
 
-    const Qty q = loc.it->qty;
-    lvl.total_qty -= q;
-    lvl.q.erase(loc.it);
+  if (!live) return;
 
-    if (lvl.q.empty()) bids_.erase(lvl_it);
-  } else {
-    auto lvl_it = asks_.find(loc.price);
-    if (lvl_it == asks_.end()) { loc_.erase(it); return false; }
-    auto& lvl = lvl_it->second;
+  // New level: only matters if it sorts into the image
+  pos = 0;
+  while (pos < img.count && !Ladder::better(px, img.levels[pos].price)) ++pos;
+  if (pos == DepthImage::kCapacity) return;
 
-    const Qty q = loc.it->qty;
-    lvl.total_qty -= q;
-    lvl.q.erase(loc.it);
+  const uint32_t last = (img.count < DepthImage::kCapacity) ? img.count : img.count - 1;
+  for (uint32_t i = last; i > pos; --i) img.levels[i] = img.levels[i - 1];
+  img.levels[pos] = LevelSummary{px, lvl->total_qty, static_cast<uint32_t>(lvl->q.size())};
+  if (img.count < DepthImage::kCapacity) ++img.count;
+  ++img.version;
+}
 
-    if (lvl.q.empty()) asks_.erase(lvl_it);
-  }
+void OrderBook::touch_(Side side, Price px) noexcept {
+  if (side == Side::Buy) touch_in_(bids_, bid_image_, px);
+  else touch_in_(asks_, ask_image_, px);
+}
 
-  loc_.erase(it);
-  return true;
+template <class Ladder>
+void OrderBook::rebuild_(const Ladder& ladder, DepthImage& img) noexcept {
+  img.count = 0;
+  ladder.for_each([&](Price px, const Level& lvl) {
+    img.levels[img.count++] = LevelSummary{px, lvl.total_qty, static_cast<uint32_t>(lvl.q.size())};
+    return img.count < DepthImage::kCapacity;
+  });
+  img.dirty = false;
+  ++img.version;
+}
+
+bool OrderBook::cancel(OrderId id) noexcept {
+  const Locator* found = loc_.find(id);
+  if (found == nullptr) return false;
+
+  const Locator loc = *found;
+  loc_.erase(id);
+
+  const bool ok = (loc.side == Side::Buy) ? cancel_in_(bids_, loc.price, loc.h)
+                                          : cancel_in_(asks_, loc.price, loc.h);
+  if (ok) touch_(loc.side, loc.price);
+  return ok;
 }
 
 bool OrderBook::modify_qty(OrderId id, Qty new_qty) noexcept {
   // Reduce-only: does not lose time priority.
   if (new_qty <= 0) return cancel(id);
 
-  auto it = loc_.find(id);
-  if (it == loc_.end()) return false;
+  const Locator* found = loc_.find(id);
+  if (found == nullptr) return false;
 
-  Locator& loc = it->second;
-  if (loc.it->qty <= 0) return false;
+  const Locator& loc = *found;
+  RestingOrder& o = orders_[loc.h];
+  if (o.qty <= 0) return false;
 
-  const Qty old_qty = loc.it->qty;
-  if (new_qty > old_qty) return false; // reduce-only
+  if (new_qty > o.qty + o.reserve) return false; // reduce-only
 
-  const Qty delta = old_qty - new_qty;
-  loc.it->qty = new_qty;
+  Level* lvl = (loc.side == Side::Buy) ? bids_.find(loc.price) : asks_.find(loc.price);
+  if (lvl == nullptr) return false;
 
-  if (loc.side == Side::Buy) {
-    auto lvl_it = bids_.find(loc.price);
-    if (lvl_it == bids_.end()) return false;
-    lvl_it->second.total_qty -= delta;
-  } else {
-    auto lvl_it = asks_.find(loc.price);
-    if (lvl_it == asks_.end()) return false;
-    lvl_it->second.total_qty -= delta;
-  }
+  // Hidden reserve absorbs the cut first; the shown slice only shrinks past it
+  const Qty shown = std::min(o.qty, new_qty);
+  o.reserve = new_qty - shown;
+  if (o.reserve == 0) peaks_.erase(id);
+
+  const Qty delta = o.qty - shown;
+  o.qty = shown;
+  lvl->total_qty -= delta;
+  feed_(loc.side, loc.price, -delta);
 
+  touch_(loc.side, loc.price);
   return true;
 }
 
 std::optional<Price> OrderBook::best_bid() const noexcept {
-  if (bids_.empty()) return std::nullopt;
-  return bids_.begin()->first;
+  return bids_.best_price();
 }
 
 std::optional<Price> OrderBook::best_ask() const noexcept {
-  if (asks_.empty()) return std::nullopt;
-  return asks_.begin()->first;
+  return asks_.best_price();
 }
 
 bool OrderBook::is_crossed() const noexcept {
@@ -112,23 +190,41 @@ bool OrderBook::is_crossed() const noexcept {
 
 std::vector<LevelSummary> OrderBook::depth(Side side, std::size_t levels) const {
   std::vector<LevelSummary> out;
+
+  if (levels <= DepthImage::kCapacity) {
+    const auto img = depth_image(side).view();
+    const std::size_t n = std::min(levels, img.size());
+    out.assign(img.begin(), img.begin() + static_cast<std::ptrdiff_t>(n));
+    return out;
+  }
+
   out.reserve(levels);
+  auto collect = [&](Price px, const Level& lvl) {
+    if (out.size() >= levels) return false;
+    out.push_back(LevelSummary{px, lvl.total_qty, static_cast<uint32_t>(lvl.q.size())});
+    return true;
+  };
 
+  if (side == Side::Buy) bids_.for_each(collect);
+  else asks_.for_each(collect);
+
+  return out;
+}
+
+const DepthImage& OrderBook::depth_image(Side side) const {
   if (side == Side::Buy) {
-    std::size_t n = 0;
-    for (const auto& [px, lvl] : bids_) {
-      if (n++ >= levels) break;
-      out.push_back(LevelSummary{px, lvl.total_qty, static_cast<uint32_t>(lvl.q.size())});
-    }
-  } else {
-    std::size_t n = 0;
-    for (const auto& [px, lvl] : asks_) {
-      if (n++ >= levels) break;
-      out.push_back(LevelSummary{px, lvl.total_qty, static_cast<uint32_t>(lvl.q.size())});
-    }
+    if (bid_image_.dirty) rebuild_(bids_, bid_image_);
+    return bid_image_;
   }
+  if (ask_image_.dirty) rebuild_(asks_, ask_image_);
+  return ask_image_;
+}
 
-  return out;
+std::size_t OrderBook::copy_depth(Side side, std::span<LevelSummary> out) const {
+  const auto img = depth_image(side).view();
+  const std::size_t n = std::min(out.size(), img.size());
+  std::copy_n(img.begin(), n, out.begin());
+  return n;
 }
 
 bool OrderBook::empty(Side side) const noexcept {
@@ -139,4 +235,13 @@ std::size_t OrderBook::level_count(Side side) const noexcept {
   return (side == Side::Buy) ? bids_.size() : asks_.size();
 }
 
+BookMemory OrderBook::memory_usage() const noexcept {
+  BookMemory m{};
+  m.order_nodes = orders_.capacity() * sizeof(Pool::Node);
+  m.cold = cold_.capacity() * sizeof(RestingCold);
+  m.locator = loc_.memory_bytes();
+  m.live_orders = orders_.live();
+  return m;
+}
+
 } // namespace msim
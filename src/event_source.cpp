@@ -0,0 +1,192 @@
+#include "msim/event_source.hpp"
+
+#include <algorithm>
+
+namespace msim {
+
+namespace {
+
+constexpr std::size_t kBlockRecords = 4096;
+
+EventFileRecord to_record(const Event& e) noexcept {
+  EventFileRecord r{};
+  r.type = static_cast<uint8_t>(type_of(e));
+  std::visit([&](const auto& x) {
+    using T = std::decay_t<decltype(x)>;
+    r.ts = x.ts;
+    r.id = x.id;
+    if constexpr (std::is_same_v<T, AddLimit>) {
+      r.side = static_cast<uint8_t>(x.side);
+      r.price = x.price;
+      r.qty = x.qty;
+      r.owner = x.owner;
+    } else if constexpr (std::is_same_v<T, AddMarket>) {
+      r.side = static_cast<uint8_t>(x.side);
+      r.qty = x.qty;
+      r.owner = x.owner;
+    } else if constexpr (std::is_same_v<T, Modify>) {
+      r.qty = x.new_qty;
+    }
+  }, e);
+  return r;
+}
+
+bool from_record(const EventFileRecord& r, Event& out) noexcept {
+  const Side side = static_cast<Side>(r.side & 0x1);
+  switch (static_cast<EventType>(r.type)) {
+    case EventType::AddLimit:  out = AddLimit{r.id, r.ts, side, r.price, r.qty, r.owner}; return true;
+    case EventType::AddMarket: out = AddMarket{r.id, r.ts, side, r.qty, r.owner}; return true;
+    case EventType::Cancel:    out = Cancel{r.id, r.ts}; return true;
+    case EventType::Modify:    out = Modify{r.id, r.ts, r.qty}; return true;
+  }
+  return false;
+}
+
+// Min-heap on (ts, src): std heap algorithms build max-heaps, so compare reversed
+bool later(const auto& a, const auto& b) noexcept {
+  if (a.ts != b.ts) return a.ts > b.ts;
+  return a.src > b.src;
+}
+
+} // namespace
+
+// ---------------- MergedSource ----------------
+
+void MergedSource::pull_(std::size_t src) {
+  Head h{};
+  h.src = src;
+  if (!owned_[src]->next(h.ev)) return;
+  h.ts = ts_of(h.ev);
+  heap_.push_back(std::move(h));
+  std::push_heap(heap_.begin(), heap_.end(), [](const Head& a, const Head& b) { return later(a, b); });
+}
+
+bool MergedSource::next(Event& out) {
+  if (heap_.empty()) return false;
+  std::pop_heap(heap_.begin(), heap_.end(), [](const Head& a, const Head& b) { return later(a, b); });
+  out = std::move(heap_.back().ev);
+  const std::size_t src = heap_.back().src;
+  heap_.pop_back();
+  pull_(src);
+  return true;
+}
+
+// ---------------- Writer ----------------
+
+bool EventFileWriter::open(const std::string& path) {
+  close();
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) {
+    ok_ = false;
+    return false;
+  }
+  std::setvbuf(file_, nullptr, _IONBF, 0); // we stage records ourselves
+
+  buf_.assign(kBlockRecords, EventFileRecord{});
+  used_ = 0;
+  last_ts_ = 0;
+  ordered_ = true;
+  any_ = false;
+
+  EventFileHeader h{};
+  h.record_size = static_cast<uint32_t>(sizeof(EventFileRecord));
+  ok_ = std::fwrite(&h, sizeof(h), 1, file_) == 1;
+  return ok_;
+}
+
+void EventFileWriter::write(const Event& e) {
+  if (!file_) return;
+  const EventFileRecord r = to_record(e);
+  if (any_ && r.ts < last_ts_) ordered_ = false;
+  last_ts_ = r.ts;
+  any_ = true;
+
+  buf_[used_++] = r;
+  if (used_ == buf_.size()) write_out_();
+}
+
+void EventFileWriter::close() {
+  if (!file_) return;
+  write_out_();
+
+  // The order flag is only known now: rewrite the header in place
+  EventFileHeader h{};
+  h.record_size = static_cast<uint32_t>(sizeof(EventFileRecord));
+  h.flags = ordered_ ? kEventFileOrdered : 0;
+  if (std::fseek(file_, 0, SEEK_SET) != 0 || std::fwrite(&h, sizeof(h), 1, file_) != 1) ok_ = false;
+  if (std::fclose(file_) != 0) ok_ = false;
+  file_ = nullptr;
+}
+
+void EventFileWriter::write_out_() {
+  if (used_ == 0) return;
+  if (std::fwrite(buf_.data(), sizeof(EventFileRecord), used_, file_) != used_) ok_ = false;
+  used_ = 0;
+}
+
+// ---------------- Reader ----------------
+
+bool EventFileReader::open(const std::string& path) {
+  close();
+  file_ = std::fopen(path.c_str(), "rb");
+  if (!file_) return false;
+
+  EventFileHeader h{};
+  ok_ = std::fread(&h, sizeof(h), 1, file_) == 1 && h.magic == kEventFileMagic &&
+        h.version == kEventFileVersion && h.record_size == sizeof(EventFileRecord);
+  if (!ok_) {
+    close();
+    return false;
+  }
+  flags_ = h.flags;
+
+  // fread drops a partial last element silently, so size the payload up front
+  const long start = std::ftell(file_);
+  if (start < 0 || std::fseek(file_, 0, SEEK_END) != 0) {
+    close();
+    return ok_ = false;
+  }
+  const long end = std::ftell(file_);
+  if (end < start || std::fseek(file_, start, SEEK_SET) != 0) {
+    close();
+    return ok_ = false;
+  }
+  torn_ = (static_cast<std::size_t>(end - start) % sizeof(EventFileRecord)) != 0;
+
+  buf_.assign(kBlockRecords, EventFileRecord{});
+  used_ = 0;
+  at_ = 0;
+  return true;
+}
+
+void EventFileReader::close() {
+  if (file_) std::fclose(file_);
+  file_ = nullptr;
+  used_ = 0;
+  at_ = 0;
+}
+
+bool EventFileReader::refill_() {
+  if (!file_) return false;
+  used_ = std::fread(buf_.data(), sizeof(EventFileRecord), buf_.size(), file_);
+  at_ = 0;
+  if (used_ < buf_.size()) {
+    // Short read: end of file, a read error, or a torn last record
+    if (std::ferror(file_) || torn_) ok_ = false;
+    std::fclose(file_); // keep what was read; later calls see the end
+    file_ = nullptr;
+  }
+  return used_ > 0;
+}
+
+bool EventFileReader::next(Event& out) {
+  if (at_ == used_ && !refill_()) return false;
+  if (!from_record(buf_[at_++], out)) {
+    ok_ = false;
+    close();
+    return false;
+  }
+  return true;
+}
+
+} // namespace msim
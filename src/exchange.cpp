@@ -0,0 +1,126 @@
+#include "msim/exchange.hpp"
+
+#include <algorithm>
+
+namespace msim {
+
+Exchange::Exchange(ExchangeConfig cfg) : cfg_(cfg) {}
+
+Exchange::~Exchange() {
+  stop();
+}
+
+InstrumentId Exchange::add_instrument(RuleSet rules, BookConfig book) {
+  if (running_) return kInvalidInstrument;
+  const auto id = static_cast<InstrumentId>(instruments_.size());
+  instruments_.push_back(std::make_unique<Instrument>(Instrument{MatchingEngine(std::move(rules), book)}));
+  instruments_.back()->engine.set_instrument(id);
+  return id;
+}
+
+void Exchange::start() {
+  if (running_) return;
+  running_ = true;
+  stop_.store(false);
+
+  shards_.clear();
+  for (std::size_t i = 0; i < cfg_.shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(cfg_.queue_capacity));
+  }
+  for (auto& s : shards_) {
+    Shard* sp = s.get();
+    sp->thread = std::thread([this, sp]() { shard_loop_(*sp); });
+  }
+}
+
+void Exchange::stop() {
+  if (!running_) return;
+  drain();
+  stop_.store(true, std::memory_order_release);
+  for (auto& s : shards_) {
+    if (s->thread.joinable()) s->thread.join();
+  }
+  shards_.clear();
+  running_ = false;
+}
+
+bool Exchange::submit(const Command& c) {
+  const InstrumentId id = c.instrument();
+  if (id >= instruments_.size()) return false;
+  if (!running_) start();
+
+  if (shards_.empty()) {
+    apply_(std::span<const Command>(&c, 1));
+    return true;
+  }
+
+  Shard& s = *shards_[shard_of(id)];
+  while (!s.queue.try_push(c)) std::this_thread::yield();
+  ++s.submitted;
+  return true;
+}
+
+void Exchange::run(std::span<const Command> cmds) {
+  if (!running_) start();
+  for (const auto& c : cmds) (void)submit(c);
+  drain();
+}
+
+void Exchange::drain() {
+  for (auto& s : shards_) {
+    while (s->applied.load(std::memory_order_acquire) != s->submitted) std::this_thread::yield();
+  }
+}
+
+std::vector<Trade> Exchange::merged_trades() const {
+  std::size_t n = 0;
+  for (const auto& in : instruments_) n += in->trades.size();
+
+  std::vector<Trade> out;
+  out.reserve(n);
+  for (const auto& in : instruments_) out.insert(out.end(), in->trades.begin(), in->trades.end());
+
+  // Per-instrument logs are already in (ts, id) order; sort is stable across shards
+  std::stable_sort(out.begin(), out.end(), [](const Trade& a, const Trade& b) {
+    if (a.ts != b.ts) return a.ts < b.ts;
+    if (a.instrument != b.instrument) return a.instrument < b.instrument;
+    return a.id < b.id;
+  });
+  return out;
+}
+
+// ---- shard side ----
+
+void Exchange::shard_loop_(Shard& s) {
+  std::vector<Command> buf(kPopBatch);
+  unsigned idle = 0;
+
+  for (;;) {
+    const std::size_t n = s.queue.try_pop_bulk(buf.data(), buf.size());
+    if (n > 0) {
+      apply_(std::span<const Command>(buf.data(), n));
+      s.applied.fetch_add(n, std::memory_order_release);
+      idle = 0;
+      continue;
+    }
+    // Queue is empty: stop only once the producer has said so (after drain)
+    if (stop_.load(std::memory_order_acquire)) return;
+    if (++idle > 64) std::this_thread::yield();
+  }
+}
+
+// Consecutive commands for one instrument go to its engine as one batch
+void Exchange::apply_(std::span<const Command> cmds) {
+  std::size_t i = 0;
+  while (i < cmds.size()) {
+    const InstrumentId id = cmds[i].instrument();
+    std::size_t j = i + 1;
+    while (j < cmds.size() && cmds[j].instrument() == id) ++j;
+
+    Instrument& in = *instruments_[id];
+    (void)in.engine.process_batch(cmds.subspan(i, j - i), in.trades);
+    i = j;
+  }
+}
+
+} // namespace msim
@@ -393,6 +393,13 @@ int main(int argc, char** argv) {
     oss << "\"best_ask\":" << (snap.best_ask ? std::to_string(*snap.best_ask) : "null") << ",";
     oss << "\"mid\":" << (snap.mid ? std::to_string(*snap.mid) : "null") << ",";
     oss << "\"last_trade\":" << (snap.last_trade ? std::to_string(*snap.last_trade) : "null") << ",";
+    if (snap.indicative) {
+      oss << "\"indicative\":{\"price\":" << snap.indicative->price
+          << ",\"matched_qty\":" << snap.indicative->matched_qty
+          << ",\"imbalance\":" << snap.indicative->imbalance << "},";
+    } else {
+      oss << "\"indicative\":null,";
+    }
 
     oss << "\"recent_trades\":[";
     for (std::size_t i = 0; i < snap.recent_trades.size(); ++i) {
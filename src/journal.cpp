@@ -0,0 +1,335 @@
+#include "msim/journal.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MSIM_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace msim {
+
+namespace {
+
+uint8_t pack_style(const Order& o) noexcept {
+  return static_cast<uint8_t>(static_cast<uint8_t>(o.type) |
+                              (static_cast<uint8_t>(o.tif) << 2) |
+                              (static_cast<uint8_t>(o.mkt_style) << 4) |
+                              (static_cast<uint8_t>(o.peg) << 6));
+}
+
+JournalRecord from_command(const Command& c, JournalKind kind) noexcept {
+  JournalRecord r{};
+  r.kind = kind;
+  r.ts = c.order.ts;
+  r.id = c.order.id;
+  r.a = c.order.owner;
+  r.price = (c.order.peg != PegType::None) ? c.order.peg_offset : c.order.price;
+  r.qty = c.order.qty;
+  r.instrument = c.order.instrument;
+  r.f0 = static_cast<uint8_t>(c.type);
+  r.f1 = static_cast<uint8_t>(c.order.side);
+  r.f2 = pack_style(c.order);
+  r.b = static_cast<uint64_t>(c.order.expire_ts);
+  r.display = c.order.display_qty;
+  r.stop = c.order.stop_price;
+  return r;
+}
+
+} // namespace
+
+Command to_command(const JournalRecord& r) noexcept {
+  Command c{};
+  c.type = static_cast<CommandType>(r.f0);
+  c.order.id = r.id;
+  c.order.ts = r.ts;
+  c.order.side = static_cast<Side>(r.f1 & 0x1);
+  c.order.type = static_cast<OrderType>(r.f2 & 0x3);
+  c.order.tif = static_cast<TimeInForce>((r.f2 >> 2) & 0x3);
+  c.order.mkt_style = static_cast<MarketStyle>((r.f2 >> 4) & 0x3);
+  c.order.peg = static_cast<PegType>((r.f2 >> 6) & 0x3);
+  if (c.order.peg != PegType::None) c.order.peg_offset = r.price;
+  else c.order.price = r.price;
+  c.order.qty = r.qty;
+  c.order.owner = r.a;
+  c.order.instrument = r.instrument;
+  c.order.expire_ts = static_cast<Ts>(r.b);
+  c.order.display_qty = r.display;
+  c.order.stop_price = r.stop;
+  return c;
+}
+
+namespace {
+
+// RulesConfig switches packed into f2 of a Rules config record
+enum : uint8_t {
+  kCfgHalt = 1 << 0,
+  kCfgBands = 1 << 1,
+  kCfgVolInterrupt = 1 << 2,
+  kCfgQueueInHalt = 1 << 3,
+  kCfgBreaker = 1 << 4
+};
+
+} // namespace
+
+void to_config(const JournalRecord& r, RulesConfig& rules, BookConfig& book) noexcept {
+  if (static_cast<JournalConfigPart>(r.f0) == JournalConfigPart::Book) {
+    book.tick_size = r.price;
+    book.ladder_slots = static_cast<std::size_t>(r.id);
+    book.reserve_orders = static_cast<std::size_t>(r.a);
+    book.dense_id_limit = static_cast<std::size_t>(r.b);
+    return;
+  }
+  rules.tick_size_ticks = r.price;
+  rules.lot_size = r.qty;
+  rules.min_qty = r.display;
+  rules.stp = static_cast<StpMode>(r.f1);
+  rules.enforce_halt = (r.f2 & kCfgHalt) != 0;
+  rules.enable_price_bands = (r.f2 & kCfgBands) != 0;
+  rules.enable_volatility_interruption = (r.f2 & kCfgVolInterrupt) != 0;
+  rules.queue_orders_during_halt = (r.f2 & kCfgQueueInHalt) != 0;
+  rules.enable_circuit_breaker = (r.f2 & kCfgBreaker) != 0;
+  rules.band_bps = static_cast<int32_t>(static_cast<uint32_t>(r.id));
+  rules.cb_drop_bps = static_cast<int32_t>(static_cast<uint32_t>(r.id >> 32));
+  rules.vol_auction_duration_ns = r.ts;
+  rules.cb_halt_duration_ns = static_cast<Ts>(r.a);
+  rules.cb_reopen_auction_duration_ns = static_cast<Ts>(r.b);
+}
+
+// ---------------- Writer ----------------
+
+bool JournalWriter::open(const std::string& path, JournalOptions opt) {
+  close();
+  opt_ = opt;
+  if (opt_.buffer_records == 0) opt_.buffer_records = 1;
+  if (opt_.checksum_every == 0) opt_.checksum_every = 1;
+
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) {
+    ok_ = false;
+    return false;
+  }
+  std::setvbuf(file_, nullptr, _IONBF, 0); // we stage records ourselves
+
+  buf_.assign(opt_.buffer_records, JournalRecord{});
+  used_ = 0;
+  seq_ = 0;
+  hash_ = kJournalHashSeed;
+  since_check_ = 0;
+
+  JournalHeader h{};
+  h.record_size = static_cast<uint32_t>(sizeof(JournalRecord));
+  ok_ = std::fwrite(&h, sizeof(h), 1, file_) == 1;
+  return ok_;
+}
+
+void JournalWriter::close() {
+  if (!file_) return;
+  if (since_check_ > 0) checksum_();
+  write_out_();
+  if (std::fclose(file_) != 0) ok_ = false;
+  file_ = nullptr;
+}
+
+void JournalWriter::flush() {
+  if (!file_) return;
+  write_out_();
+  if (std::fflush(file_) != 0) ok_ = false;
+}
+
+void JournalWriter::command(const Command& c) {
+  append_(from_command(c, JournalKind::Command));
+}
+
+void JournalWriter::reject(const Command& c, RejectReason why) {
+  JournalRecord r = from_command(c, JournalKind::Reject);
+  r.f1 = static_cast<uint8_t>(r.f1 | (static_cast<uint8_t>(why) << 1));
+  append_(r);
+}
+
+void JournalWriter::fill(const Trade& t) {
+  JournalRecord r{};
+  r.kind = JournalKind::Fill;
+  r.ts = t.ts;
+  r.id = t.maker_order_id;
+  r.a = t.taker_order_id;
+  r.b = t.id;
+  r.price = t.price;
+  r.qty = t.qty;
+  r.instrument = t.instrument;
+  append_(r);
+}
+
+void JournalWriter::phase(Ts ts, MarketPhase from, MarketPhase to) {
+  JournalRecord r{};
+  r.kind = JournalKind::Phase;
+  r.ts = ts;
+  r.f0 = static_cast<uint8_t>(to);
+  r.f1 = static_cast<uint8_t>(from);
+  append_(r);
+}
+
+void JournalWriter::config(InstrumentId instrument, const RulesConfig& rules, const BookConfig& book) {
+  JournalRecord r{};
+  r.kind = JournalKind::Config;
+  r.instrument = instrument;
+  r.f0 = static_cast<uint8_t>(JournalConfigPart::Rules);
+  r.price = rules.tick_size_ticks;
+  r.qty = rules.lot_size;
+  r.display = rules.min_qty;
+  r.f1 = static_cast<uint8_t>(rules.stp);
+  r.f2 = static_cast<uint8_t>((rules.enforce_halt ? kCfgHalt : 0) | (rules.enable_price_bands ? kCfgBands : 0) |
+                              (rules.enable_volatility_interruption ? kCfgVolInterrupt : 0) |
+                              (rules.queue_orders_during_halt ? kCfgQueueInHalt : 0) |
+                              (rules.enable_circuit_breaker ? kCfgBreaker : 0));
+  r.id = static_cast<uint64_t>(static_cast<uint32_t>(rules.band_bps)) |
+         (static_cast<uint64_t>(static_cast<uint32_t>(rules.cb_drop_bps)) << 32);
+  r.ts = rules.vol_auction_duration_ns;
+  r.a = static_cast<uint64_t>(rules.cb_halt_duration_ns);
+  r.b = static_cast<uint64_t>(rules.cb_reopen_auction_duration_ns);
+  append_(r);
+
+  r = JournalRecord{};
+  r.kind = JournalKind::Config;
+  r.instrument = instrument;
+  r.f0 = static_cast<uint8_t>(JournalConfigPart::Book);
+  r.price = book.tick_size;
+  r.id = book.ladder_slots;
+  r.a = book.reserve_orders;
+  r.b = book.dense_id_limit;
+  append_(r);
+}
+
+void JournalWriter::append_(JournalRecord r) {
+  if (!file_) return;
+  r.seq = seq_++;
+  hash_ = journal_hash(hash_, r);
+  buf_[used_++] = r;
+  if (used_ == buf_.size()) write_out_();
+  if (++since_check_ == opt_.checksum_every) checksum_();
+}
+
+void JournalWriter::checksum_() {
+  JournalRecord r{};
+  r.kind = JournalKind::Checksum;
+  r.seq = seq_++;
+  r.a = hash_;
+  r.b = since_check_;
+  hash_ = kJournalHashSeed;
+  since_check_ = 0;
+
+  buf_[used_++] = r;
+  if (used_ == buf_.size()) write_out_();
+}
+
+void JournalWriter::write_out_() {
+  if (used_ == 0) return;
+  if (std::fwrite(buf_.data(), sizeof(JournalRecord), used_, file_) != used_) ok_ = false;
+  used_ = 0;
+}
+
+// ---------------- Reader ----------------
+
+JournalScan verify_journal(std::span<const JournalRecord> records) noexcept {
+  JournalScan out{};
+  uint64_t h = kJournalHashSeed;
+  uint64_t n = 0;
+
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    const JournalRecord& r = records[i];
+    if (r.seq != i) {
+      out.status = JournalStatus::SequenceGap;
+      return out;
+    }
+    if (r.kind == JournalKind::Checksum) {
+      if (r.a != h || r.b != n) {
+        out.status = JournalStatus::BadChecksum;
+        return out;
+      }
+      out.verified = i + 1;
+      h = kJournalHashSeed;
+      n = 0;
+      continue;
+    }
+    h = journal_hash(h, r);
+    ++n;
+  }
+
+  if (out.verified != records.size()) out.status = JournalStatus::UnsealedTail;
+  return out;
+}
+
+JournalScan read_journal(const std::string& path, std::vector<JournalRecord>& out) {
+  out.clear();
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return JournalScan{JournalStatus::IoError, 0};
+
+  JournalHeader h{};
+  if (std::fread(&h, sizeof(h), 1, f) != 1 || h.magic != kJournalMagic ||
+      h.version != kJournalVersion || h.record_size != sizeof(JournalRecord)) {
+    std::fclose(f);
+    return JournalScan{JournalStatus::BadHeader, 0};
+  }
+
+  JournalRecord r{};
+  while (std::fread(&r, sizeof(r), 1, f) == 1) out.push_back(r); // a torn last record is ignored
+  std::fclose(f);
+  return verify_journal(out);
+}
+
+JournalStatus MappedJournal::open(const std::string& path) {
+  close();
+
+#if MSIM_HAVE_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return JournalStatus::IoError;
+
+  struct stat st{};
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    return JournalStatus::IoError;
+  }
+  if (static_cast<std::size_t>(st.st_size) < sizeof(JournalHeader)) {
+    ::close(fd);
+    return JournalStatus::BadHeader;
+  }
+
+  const auto len = static_cast<std::size_t>(st.st_size);
+  void* p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return JournalStatus::IoError;
+  ::madvise(p, len, MADV_SEQUENTIAL);
+
+  JournalHeader h{};
+  std::memcpy(&h, p, sizeof(h));
+  if (h.magic != kJournalMagic || h.version != kJournalVersion || h.record_size != sizeof(JournalRecord)) {
+    ::munmap(p, len);
+    return JournalStatus::BadHeader;
+  }
+
+  map_ = p;
+  map_len_ = len;
+  // Header is 16 bytes, so records stay 8-byte aligned within the page-aligned map
+  const auto* first = reinterpret_cast<const JournalRecord*>(static_cast<const char*>(p) + sizeof(JournalHeader));
+  records_ = std::span<const JournalRecord>(first, (len - sizeof(JournalHeader)) / sizeof(JournalRecord));
+  return JournalStatus::Ok;
+#else
+  const JournalScan scan = read_journal(path, loaded_);
+  if (scan.status == JournalStatus::IoError || scan.status == JournalStatus::BadHeader) return scan.status;
+  records_ = loaded_;
+  return JournalStatus::Ok;
+#endif
+}
+
+void MappedJournal::close() noexcept {
+#if MSIM_HAVE_MMAP
+  if (map_) ::munmap(map_, map_len_);
+#endif
+  map_ = nullptr;
+  map_len_ = 0;
+  loaded_.clear();
+  records_ = {};
+}
+
+} // namespace msim
@@ -62,6 +62,7 @@ LiveSnapshot LiveWorld::snapshot(std::size_t max_trades) const {
   s.best_ask = cache_.best_ask;
   s.mid = cache_.mid;
   s.last_trade = cache_.last_trade;
+  s.indicative = cache_.indicative;
 
   const std::size_t n = std::min<std::size_t>(max_trades, cache_.trades.size());
   s.recent_trades.reserve(n);
@@ -154,6 +155,7 @@ void LiveWorld::update_cache_with_engine_locked_(Ts ts, const std::vector<Trade>
   cache_.best_ask = engine_.book().best_ask();
   cache_.mid = compute_mid_(cache_.best_bid, cache_.best_ask);
   cache_.last_trade = engine_.rules().last_trade_price();
+  cache_.indicative = engine_.indicative_auction();
 
   for (const auto& t : new_trades) {
     cache_.trades.push_back(t);
@@ -168,10 +170,17 @@ void LiveWorld::update_cache_with_engine_locked_(Ts ts, const std::vector<Trade>
   cache_.tops.push_back(top);
   if (cache_.tops.size() > max_cache_tops_) cache_.tops.pop_front();
 
-  LiveBookDepth bd{};
-  bd.bids = extract_depth_(engine_.book(), Side::Buy, depth_cache_levels_);
-  bd.asks = extract_depth_(engine_.book(), Side::Sell, depth_cache_levels_);
-  cache_.depth = std::move(bd);
+  // Depth only changes when the book's image version moves
+  const auto& bimg = engine_.book().depth_image(Side::Buy);
+  if (bimg.version != cache_.bid_depth_version) {
+    fill_depth_(cache_.depth.bids, bimg, depth_cache_levels_);
+    cache_.bid_depth_version = bimg.version;
+  }
+  const auto& aimg = engine_.book().depth_image(Side::Sell);
+  if (aimg.version != cache_.ask_depth_version) {
+    fill_depth_(cache_.depth.asks, aimg, depth_cache_levels_);
+    cache_.ask_depth_version = aimg.version;
+  }
 }
 
 void LiveWorld::worker_() {
@@ -198,6 +207,7 @@ void LiveWorld::worker_() {
     view.best_ask = ba;
     view.mid = mid;
     view.last_trade = engine_.rules().last_trade_price();
+    view.indicative = engine_.indicative_auction();
 
     for (auto& ap : agents_) {
       AgentState self{};
@@ -1,12 +1,12 @@
-#include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
-#include <vector>
 #include <utility>
 
+#include "msim/journal.hpp"
 #include "msim/rules.hpp"
 #include "msim/matching_engine.hpp"
+#include "msim/result_sink.hpp"
 #include "msim/world.hpp"
 
 // NoiseTrader lives in msim::agents and takes NoiseTraderConfig
@@ -15,29 +15,6 @@
 // MarketMaker + params live in msim (per your header)
 #include "msim/agents/market_maker.hpp"
 
-static void write_trades_csv(const std::string& path, const std::vector<msim::Trade>& trades) {
-  std::ofstream f(path);
-  f << "trade_id,ts,price,qty,maker_id,taker_id\n";
-  for (const auto& t : trades) {
-    f << t.id << "," << t.ts << "," << t.price << "," << t.qty << ","
-      << t.maker_order_id << "," << t.taker_order_id << "\n";
-  }
-}
-
-static void write_top_csv(const std::string& path, const std::vector<msim::BookTop>& tops) {
-  std::ofstream f(path);
-  f << "ts,best_bid,best_ask,mid\n";
-  for (const auto& x : tops) {
-    f << x.ts << ",";
-    if (x.best_bid) f << *x.best_bid;
-    f << ",";
-    if (x.best_ask) f << *x.best_ask;
-    f << ",";
-    if (x.mid) f << *x.mid;
-    f << "\n";
-  }
-}
-
 int main(int argc, char** argv) {
   uint64_t seed = 1;
   double horizon = 2.0; // seconds
@@ -50,6 +27,17 @@ int main(int argc, char** argv) {
 
   // IMPORTANT: braces avoid "most vexing parse"
   msim::MatchingEngine eng{msim::RuleSet(rcfg)};
+
+  // Optional write-ahead journal (must outlive the run)
+  msim::JournalWriter journal;
+  if (argc >= 4) {
+    if (!journal.open(argv[3])) {
+      std::cerr << "cannot open journal " << argv[3] << "\n";
+      return 1;
+    }
+    eng.set_journal(&journal);
+  }
+
   msim::World w{std::move(eng)};
 
   // ---- Agents ----
@@ -66,14 +54,19 @@ int main(int argc, char** argv) {
   msim::MarketMakerParams mm_params{};
   w.add_agent(std::make_unique<msim::MarketMaker>(msim::OwnerId{2}, rcfg, mm_params));
 
-  auto res = w.run(seed, horizon);
+  // trades.csv / top.csv are written as the run goes, not held until the end
+  msim::CsvSink out("", msim::kSinkTrades | msim::kSinkTops);
+  if (!out.ok()) {
+    std::cerr << "cannot open output files\n";
+    return 1;
+  }
+  w.run(seed, horizon, out);
 
-  write_trades_csv("trades.csv", res.trades);
-  write_top_csv("top.csv", res.tops);
+  journal.close();
 
   std::cout << "seed=" << seed
             << " horizon_s=" << horizon
-            << " trades=" << res.trades.size()
+            << " trades=" << out.trades
             << "\n";
 
   return 0;
@@ -1,8 +1,8 @@
 #include "msim/matching_engine.hpp"
 #include <algorithm>
-#include <set>
 #include <cstdlib>   // std::abs
 #include <span>
+#include <vector>
 
 namespace msim {
 
@@ -11,13 +11,19 @@ static Price mul_div_bps(Price x, int32_t num_bps, int32_t den_bps) noexcept {
 }
 
 void MatchingEngine::start_trading_at_last(Ts end_ts) noexcept {
+  const MarketPhase before = rules_.phase();
   tal_end_ts_ = end_ts;
+  arm_(end_ts, TimerKind::TalEnd);
   rules_.set_phase(MarketPhase::TradingAtLast);
+  if (journal_) journal_->phase(end_ts, before, MarketPhase::TradingAtLast);
 }
 
 void MatchingEngine::start_closing_auction(Ts end_ts) noexcept {
+  const MarketPhase before = rules_.phase();
   auction_end_ts_ = end_ts;
+  arm_(end_ts, TimerKind::AuctionEnd);
   rules_.set_phase(MarketPhase::ClosingAuction);
+  if (journal_) journal_->phase(end_ts, before, MarketPhase::ClosingAuction);
 }
 
 void MatchingEngine::maybe_trigger_circuit_breaker(std::span<const Trade> trades) {
@@ -42,25 +48,57 @@ void MatchingEngine::maybe_trigger_circuit_breaker(std::span<const Trade> trades
   halt_end_ts_ = last.ts + cfg.cb_halt_duration_ns;
   reopen_auction_end_ts_ = halt_end_ts_ + cfg.cb_reopen_auction_duration_ns;
 
-  // Prepare reopen auction: move current book liquidity into auction queue
-  // (so the reopening auction includes the frozen book + new queued orders)
-  for (auto& [px, lvl] : book_.bids_) {
-    for (auto& o : lvl.q) auction_queue_.push_back(std::move(o));
-  }
-  for (auto& [px, lvl] : book_.asks_) {
-    for (auto& o : lvl.q) auction_queue_.push_back(std::move(o));
-  }
-
-  book_.bids_.clear();
-  book_.asks_.clear();
-  book_.loc_.clear();
+  // Prepare reopen auction: the frozen book takes part in place. Only level totals
+  // enter the curve (O(levels)); resting orders keep their nodes and priority, and
+  // book edits during the halt are mirrored into the curve by the book itself.
+  book_.bids_.for_each([&](Price px, const OrderBook::Level& lvl) {
+    book_.auction_curve_.add(Side::Buy, OrderType::Limit, px, lvl.total_qty);
+    return true;
+  });
+  book_.asks_.for_each([&](Price px, const OrderBook::Level& lvl) {
+    book_.auction_curve_.add(Side::Sell, OrderType::Limit, px, lvl.total_qty);
+    return true;
+  });
+  book_.auction_feed_ = true;
+  book_in_auction_ = true;
 
   // The reopening auction ends at reopen_auction_end_ts_
   auction_end_ts_ = reopen_auction_end_ts_;
+  arm_(halt_end_ts_, TimerKind::HaltEnd);
+  arm_(auction_end_ts_, TimerKind::AuctionEnd);
+}
+
+// ---- engine timers ----
+
+void MatchingEngine::arm_(Ts at, TimerKind kind, Ts end) {
+  timers_.push_back(EngineTimer{at, kind, timer_seq_++, end});
+  std::push_heap(timers_.begin(), timers_.end());
+  next_deadline_ = std::min(next_deadline_, at);
+}
+
+// Pop every timer due at ts, earliest first; same-ts timers go by kind, then
+// arming order. Session starts run here, ahead of the phase checks in flush.
+void MatchingEngine::fire_timers_(Ts ts) {
+  while (!timers_.empty() && timers_.front().ts <= ts) {
+    std::pop_heap(timers_.begin(), timers_.end());
+    const EngineTimer t = timers_.back();
+    timers_.pop_back();
+
+    if (t.kind == TimerKind::TalStart && ts < t.end) start_trading_at_last(t.end);
+    else if (t.kind == TimerKind::CloseStart && ts < t.end) start_closing_auction(t.end);
+  }
 }
 
 std::vector<Trade> MatchingEngine::flush(Ts ts) {
   std::vector<Trade> out;
+  (void)flush(ts, out);
+  return out;
+}
+
+std::size_t MatchingEngine::flush_due_(Ts ts, std::vector<Trade>& trades) {
+  const std::size_t first = trades.size();
+  fire_timers_(ts); // session starts journal their own phase change
+  const MarketPhase before = rules_.phase();
 
   // TAL expiry -> back to Continuous (session controller decides next phase)
   if (rules_.phase() == MarketPhase::TradingAtLast && tal_end_ts_ > 0 && ts >= tal_end_ts_) {
@@ -77,7 +115,8 @@ std::vector<Trade> MatchingEngine::flush(Ts ts) {
   if ((rules_.phase() == MarketPhase::Auction || rules_.phase() == MarketPhase::ClosingAuction) &&
       auction_end_ts_ > 0 && ts >= auction_end_ts_) {
 
-    out = uncross_auction(auction_end_ts_);
+    expire_(auction_end_ts_); // orders that lapsed during the call miss the uncross
+    uncross_auction(auction_end_ts_, trades);
 
     if (rules_.phase() == MarketPhase::ClosingAuction) {
       rules_.set_phase(MarketPhase::Closed);
@@ -85,13 +124,28 @@ std::vector<Trade> MatchingEngine::flush(Ts ts) {
       rules_.set_phase(MarketPhase::Continuous);
     }
 
-    rules_.on_trades(out);
+    const auto printed = std::span<const Trade>(trades).subspan(first);
+    rules_.on_trades(printed);
     // CB can trigger on auction prints too (optional). Keep deterministic:
     // Only trigger from Continuous, so this won't re-trigger here.
-    maybe_trigger_circuit_breaker(out);
+    maybe_trigger_circuit_breaker(printed);
+    elect_stops_(printed, trades);
   }
 
-  return out;
+  expire_(ts);
+
+  // Reopening or expiries may have moved the lit BBO under the pegs
+  settle_peg_crosses_(ts, trades);
+
+  if (journal_) {
+    journal_->fills(std::span<const Trade>(trades).subspan(first));
+    if (rules_.phase() != before) journal_->phase(ts, before, rules_.phase());
+  }
+
+  // Timers armed above (e.g. a breaker tripped by the uncross) already lowered it
+  next_deadline_ = std::min(timers_.empty() ? std::numeric_limits<Ts>::max() : timers_.front().ts,
+                            expiries_.next_due());
+  return trades.size() - first;
 }
 
 Trade MatchingEngine::make_trade(Ts ts, Price px, Qty q, OrderId maker, OrderId taker) {
@@ -102,31 +156,29 @@ Trade MatchingEngine::make_trade(Ts ts, Price px, Qty q, OrderId maker, OrderId
   t.qty = q;
   t.maker_order_id = maker;
   t.taker_order_id = taker;
+  t.instrument = instrument_;
   return t;
 }
 
 Qty MatchingEngine::available_liquidity(const Order& taker) const noexcept {
   Qty avail = 0;
 
-  if (taker.side == Side::Buy) {
-    for (auto it = book_.asks_.begin(); it != book_.asks_.end(); ++it) {
-      const Price px = it->first;
-      if (taker.type == OrderType::Limit && px > taker.price) break;
-      for (const auto& o : it->second.q) {
-        avail += o.qty;
-        if (avail >= taker.qty) return avail;
-      }
+  auto accumulate = [&](Price px, const OrderBook::Level& lvl) {
+    if (taker.type == OrderType::Limit) {
+      if (taker.side == Side::Buy && px > taker.price) return false;
+      if (taker.side == Side::Sell && px < taker.price) return false;
     }
-  } else {
-    for (auto it = book_.bids_.begin(); it != book_.bids_.end(); ++it) {
-      const Price px = it->first;
-      if (taker.type == OrderType::Limit && px < taker.price) break;
-      for (const auto& o : it->second.q) {
-        avail += o.qty;
-        if (avail >= taker.qty) return avail;
-      }
-    }
-  }
+    bool more = true;
+    book_.orders_.for_each(lvl.q, [&](NodeHandle h, const RestingOrder&) {
+      avail += book_.leaves_(h); // hidden reserve is executable too
+      more = (avail < taker.qty);
+      return more;
+    });
+    return more;
+  };
+
+  if (taker.side == Side::Buy) book_.asks_.for_each(accumulate);
+  else book_.bids_.for_each(accumulate);
 
   return avail;
 }
@@ -177,358 +229,796 @@ bool MatchingEngine::should_trigger_volatility_auction(const Order& incoming) co
   return breaches_price_band(*exec_px, *ref_px);
 }
 
-MatchResult MatchingEngine::queue_in_auction(Order incoming) {
-  MatchResult out{};
+void MatchingEngine::queue_in_auction(Order incoming) {
+  report_(ExecType::AuctionQueued, incoming, incoming.qty, incoming.qty);
+  book_.auction_curve_.add(incoming.side, incoming.type, incoming.price, incoming.qty);
   auction_queue_.push_back(std::move(incoming));
-  return out;
 }
 
-Qty MatchingEngine::executable_volume_at(Price px) const noexcept {
-  Qty buy = 0;
-  Qty sell = 0;
+std::optional<IndicativeAuction> MatchingEngine::indicative_auction() const {
+  if (auction_queue_.empty() && !book_in_auction_) return std::nullopt;
+  if (book_.auction_curve_.exact()) return book_.auction_curve_.indicative(reference_price());
+  return clear_from_queue_();
+}
+
+// Fallback when the curve cannot bucket the interest: single pass over the sorted
+// limit prices. Candidate prices and tie-breaking match AuctionCurve: max
+// executable volume, then closest to the reference price, then the lowest price.
+std::optional<IndicativeAuction> MatchingEngine::clear_from_queue_() const {
 
+  struct CurvePoint {
+    Price px;
+    int64_t buy;
+    int64_t sell;
+  };
+  std::vector<CurvePoint> pts;
+  pts.reserve(auction_queue_.size());
+
+  int64_t mkt_buy = 0;
+  int64_t mkt_sell = 0;
+  int64_t limit_buy = 0;
   for (const auto& o : auction_queue_) {
     if (o.type == OrderType::Market) {
-      if (o.side == Side::Buy) buy += o.qty;
-      else sell += o.qty;
-      continue;
-    }
-    if (o.side == Side::Buy) {
-      if (o.price >= px) buy += o.qty;
+      if (o.side == Side::Buy) mkt_buy += o.qty;
+      else mkt_sell += o.qty;
+    } else if (o.side == Side::Buy) {
+      pts.push_back(CurvePoint{o.price, o.qty, 0});
+      limit_buy += o.qty;
     } else {
-      if (o.price <= px) sell += o.qty;
+      pts.push_back(CurvePoint{o.price, 0, o.qty});
     }
   }
-
-  return std::min(buy, sell);
-}
-
-std::optional<Price> MatchingEngine::compute_clearing_price() const noexcept {
-  if (auction_queue_.empty()) return std::nullopt;
-
-  std::set<Price> candidates;
-  for (const auto& o : auction_queue_) {
-    if (o.type == OrderType::Limit) candidates.insert(o.price);
+  if (book_in_auction_) {
+    book_.bids_.for_each([&](Price px, const OrderBook::Level& lvl) {
+      pts.push_back(CurvePoint{px, lvl.total_qty, 0});
+      limit_buy += lvl.total_qty;
+      return true;
+    });
+    book_.asks_.for_each([&](Price px, const OrderBook::Level& lvl) {
+      pts.push_back(CurvePoint{px, 0, lvl.total_qty});
+      return true;
+    });
   }
-  if (candidates.empty()) return std::nullopt;
+  if (pts.empty()) return std::nullopt;
+
+  std::sort(pts.begin(), pts.end(),
+            [](const CurvePoint& a, const CurvePoint& b) { return a.px < b.px; });
 
   const auto ref = reference_price();
-  Qty best_vol = -1;
-  Price best_px = *candidates.begin();
+  int64_t buy_below = 0;          // limit buys priced strictly below the candidate
+  int64_t sell_at_or_below = mkt_sell;
+  int64_t best_vol = -1;
+  int64_t best_imb = 0;
+  Price best_px = pts.front().px;
+
+  for (std::size_t i = 0; i < pts.size();) {
+    const Price px = pts[i].px;
+    int64_t buy_here = 0;
+    for (; i < pts.size() && pts[i].px == px; ++i) {
+      buy_here += pts[i].buy;
+      sell_at_or_below += pts[i].sell;
+    }
 
-  for (Price px : candidates) {
-    const Qty v = executable_volume_at(px);
-    if (v > best_vol) {
+    const int64_t demand = mkt_buy + limit_buy - buy_below;
+    const int64_t v = std::min(demand, sell_at_or_below);
+    buy_below += buy_here;
+
+    bool take = (v > best_vol);
+    if (!take && v == best_vol && ref) {
+      const auto d_best = std::abs(best_px - *ref);
+      const auto d_cur  = std::abs(px - *ref);
+      take = (d_cur < d_best);
+    }
+    // without a reference the earlier (lower) price already wins
+    if (take) {
       best_vol = v;
       best_px = px;
-    } else if (v == best_vol) {
-      if (ref) {
-        const auto d_best = std::abs(best_px - *ref);
-        const auto d_cur  = std::abs(px - *ref);
-        if (d_cur < d_best) best_px = px;
-      } else {
-        if (px < best_px) best_px = px;
-      }
+      best_imb = demand - sell_at_or_below;
     }
   }
 
   if (best_vol <= 0) return std::nullopt;
-  return best_px;
+  return IndicativeAuction{best_px, best_vol, best_imb};
 }
 
-std::vector<Trade> MatchingEngine::uncross_auction(Ts uncross_ts) {
-  std::vector<Trade> trades;
-  if (auction_queue_.empty()) return trades;
+// Collect side S's share of `volume` in price-time priority: queued market orders,
+// then by limit price; at equal price the frozen book (rested before the halt)
+// goes ahead of orders queued during the auction, which are taken by (ts, id).
+template <Side S>
+void MatchingEngine::allocate_uncross_(Price clearing_px, int64_t volume, std::vector<AuctionFill>& out) {
+  auto better = [](Price a, Price b) { return (S == Side::Buy) ? a > b : a < b; };
+  auto eligible = [&](Price p) { return !better(clearing_px, p); };
+
+  std::vector<std::size_t> queued;
+  for (std::size_t i = 0; i < auction_queue_.size(); ++i) {
+    const Order& o = auction_queue_[i];
+    if (o.side == S && o.qty > 0 && (o.type == OrderType::Market || eligible(o.price))) queued.push_back(i);
+  }
+  std::sort(queued.begin(), queued.end(), [&](std::size_t a, std::size_t b) {
+    const Order& x = auction_queue_[a];
+    const Order& y = auction_queue_[b];
+    if (x.type != y.type) return x.type == OrderType::Market;
+    if (x.type == OrderType::Limit && x.price != y.price) return better(x.price, y.price);
+    if (x.ts != y.ts) return x.ts < y.ts;
+    return x.id < y.id;
+  });
+
+  int64_t left = volume;
+  std::size_t k = 0;
+  auto take = [&](OrderId id, OwnerId owner, Qty qty, Price px, NodeHandle h, OrderBook::Level* lvl,
+                  std::size_t qi) {
+    const Qty q = static_cast<Qty>(std::min<int64_t>(qty, left));
+    out.push_back(AuctionFill{id, owner, q, qty - q, px, h, lvl, qi});
+    left -= q;
+  };
+  auto take_queued = [&](const Price* level_px) {
+    for (; left > 0 && k < queued.size(); ++k) {
+      const Order& o = auction_queue_[queued[k]];
+      if (level_px && o.type == OrderType::Limit && !better(o.price, *level_px)) return;
+      take(o.id, o.owner, o.qty, o.price, kNilNode, nullptr, queued[k]);
+    }
+  };
 
-  const auto px_opt = compute_clearing_price();
-  if (!px_opt) {
-    // If no clearing price, make all LIMIT orders resting; drop MARKET orders.
-    for (auto& o : auction_queue_) {
-      if (o.type == OrderType::Limit && o.qty > 0) {
-        o.ts = uncross_ts;
-        (void)book_.add_resting_limit(o);
+  if (book_in_auction_) {
+    auto& ladder = [this]() -> auto& {
+      if constexpr (S == Side::Buy) return book_.bids_;
+      else return book_.asks_;
+    }();
+    ladder.for_each([&](Price px, OrderBook::Level& lvl) {
+      if (left <= 0 || !eligible(px)) return false;
+      take_queued(&px);
+      book_.orders_.for_each(lvl.q, [&](NodeHandle h, RestingOrder& r) {
+        if (left <= 0) return false;
+        take(r.id, r.owner, r.qty, px, h, &lvl, 0);
+        out.back().leaves += r.reserve; // auctions match the shown slice only
+        return true;
+      });
+      return left > 0;
+    });
+  }
+  take_queued(nullptr);
+}
+
+template <Side S>
+void MatchingEngine::apply_uncross_(std::span<const AuctionFill> fills, Ts ts) {
+  auto& ladder = [this]() -> auto& {
+    if constexpr (S == Side::Buy) return book_.bids_;
+    else return book_.asks_;
+  }();
+
+  // Levels are erased only after the pass: an erase can re-center the ladder
+  // and move the levels the remaining fills point at
+  std::vector<Price> touched;
+  std::vector<Price> emptied;
+  for (const auto& f : fills) {
+    if (f.h == kNilNode) {
+      auction_queue_[f.queue_idx].qty -= f.qty;
+      continue;
+    }
+    // Book fills arrive front-first per level, so removals never skip a node
+    auto& lvl = *f.lvl;
+    auto& maker = book_.orders_[f.h];
+    maker.qty -= f.qty;
+    lvl.total_qty -= f.qty;
+    if (maker.qty == 0 && !book_.replenish_(lvl, S, f.px, f.h, ts)) {
+      book_.erase_locator(maker.id);
+      book_.remove_(lvl, f.h);
+    }
+    if (touched.empty() || touched.back() != f.px) touched.push_back(f.px);
+    if (lvl.total_qty == 0) emptied.push_back(f.px);
+  }
+  for (const Price px : emptied) ladder.erase(px);
+  for (const Price px : touched) book_.touch_(S, px);
+}
+
+void MatchingEngine::uncross_auction(Ts uncross_ts, std::vector<Trade>& trades) {
+  if (auction_queue_.empty() && !book_in_auction_) return;
+
+  const auto ind = indicative_auction();
+  book_.auction_feed_ = false;
+
+  if (ind) {
+    std::vector<AuctionFill> buys;
+    std::vector<AuctionFill> sells;
+    allocate_uncross_<Side::Buy>(ind->price, ind->matched_qty, buys);
+    allocate_uncross_<Side::Sell>(ind->price, ind->matched_qty, sells);
+
+    std::size_t i = 0, j = 0;
+    Qty b_left = buys.empty() ? 0 : buys[0].qty;
+    Qty s_left = sells.empty() ? 0 : sells[0].qty;
+    auto report_fill = [&](const AuctionFill& f, Side s, Qty q, Qty left) {
+      const Qty leaves = f.leaves + left;
+      exec_.push(ExecReport{f.id, f.owner, uncross_ts, trades.back().id, ind->price, q, leaves, instrument_, s,
+                            leaves == 0 ? ExecType::Fill : ExecType::PartialFill, RejectReason::None, false});
+    };
+
+    while (i < buys.size() && j < sells.size()) {
+      const Qty q = std::min(b_left, s_left);
+      if (q > 0) trades.push_back(make_trade(uncross_ts, ind->price, q, sells[j].id, buys[i].id));
+      b_left -= q;
+      s_left -= q;
+      if (reports_on_ && q > 0) {
+        report_fill(buys[i], Side::Buy, q, b_left);
+        report_fill(sells[j], Side::Sell, q, s_left);
       }
+      if (b_left == 0 && ++i < buys.size()) b_left = buys[i].qty;
+      if (s_left == 0 && ++j < sells.size()) s_left = sells[j].qty;
     }
-    auction_queue_.clear();
-    return trades;
+
+    apply_uncross_<Side::Buy>(buys, uncross_ts);
+    apply_uncross_<Side::Sell>(sells, uncross_ts);
   }
+  book_in_auction_ = false;
 
-  const Price clearing_px = *px_opt;
+  // Price-time allocation leaves the residual uncrossed, so every remaining LIMIT
+  // order can rest; unfilled MARKET orders are dropped. Frozen-book orders never moved.
+  for (auto& o : auction_queue_) {
+    if (o.qty <= 0) continue;
+    o.ts = uncross_ts;
+    if (o.type == OrderType::Limit && book_.add_resting_limit(o)) {
+      report_(ExecType::New, o, o.qty, o.qty);
+      track_expiry_(o);
+    } else {
+      report_(ExecType::Expire, o, o.qty, 0);
+    }
+  }
+  auction_queue_.clear();
+  book_.auction_curve_.clear();
+}
 
-  std::vector<Order> buys;
-  std::vector<Order> sells;
+MatchResult MatchingEngine::process(Order incoming) {
+  MatchResult out{};
+  const ProcessStatus st = process(std::move(incoming), out.trades);
+  out.resting = st.resting;
+  out.filled_qty = st.filled_qty;
+  out.status = st.status;
+  out.reject_reason = st.reject_reason;
+  return out;
+}
 
-  for (const auto& o : auction_queue_) {
-    Order copy = o;
-    copy.ts = uncross_ts;
+void MatchingEngine::settle_(std::span<const Trade> fills, ProcessStatus& st) {
+  st.filled_qty = 0;
+  for (const auto& tr : fills) st.filled_qty += tr.qty;
 
-    const bool eligible_buy  = (copy.side == Side::Buy)  && (copy.type == OrderType::Market || copy.price >= clearing_px);
-    const bool eligible_sell = (copy.side == Side::Sell) && (copy.type == OrderType::Market || copy.price <= clearing_px);
+  rules_.on_trades(fills);
+  maybe_trigger_circuit_breaker(fills);
+}
 
-    if (eligible_buy) buys.push_back(copy);
-    if (eligible_sell) sells.push_back(copy);
-  }
+ProcessStatus MatchingEngine::process(Order incoming, std::vector<Trade>& trades) {
+  const std::size_t first = trades.size();
 
-  auto pri = [](const Order& a, const Order& b) {
-    if (a.ts != b.ts) return a.ts < b.ts;
-    return a.id < b.id;
-  };
-  std::sort(buys.begin(), buys.end(), pri);
-  std::sort(sells.begin(), sells.end(), pri);
+  // Finalize any due phase endings BEFORE processing this message
+  (void)flush(incoming.ts, trades);
+  if (!journal_) return process_(std::move(incoming), trades, first);
+
+  const std::size_t own = trades.size();
+  const MarketPhase before = rules_.phase();
+  const ProcessStatus st = process_(incoming, trades, first);
+  journal_message_(Command::submit(incoming), st, std::span<const Trade>(trades).subspan(own), before);
+  return st;
+}
 
-  std::size_t i = 0, j = 0;
-  while (i < buys.size() && j < sells.size()) {
-    auto& b = buys[i];
-    auto& s = sells[j];
-    if (b.qty <= 0) { ++i; continue; }
-    if (s.qty <= 0) { ++j; continue; }
+// Inputs are journaled after the engine decided on them, so one record says
+// whether the message was accepted; its fills and any phase change follow it.
+void MatchingEngine::journal_message_(const Command& c, const ProcessStatus& st,
+                                      std::span<const Trade> fills, MarketPhase before) {
+  if (st.status == OrderStatus::Rejected) journal_->reject(c, st.reject_reason);
+  else journal_->command(c);
+  journal_->fills(fills);
+  if (rules_.phase() != before) journal_->phase(c.order.ts, before, rules_.phase());
+}
 
-    const Qty q = std::min(b.qty, s.qty);
-    trades.push_back(make_trade(uncross_ts, clearing_px, q, s.id, b.id));
-    b.qty -= q;
-    s.qty -= q;
+ProcessStatus MatchingEngine::apply_(const Command& c, std::vector<Trade>& trades, std::size_t first) {
+  if (c.type == CommandType::Submit) return process_(c.order, trades, first);
+
+  // cancel/modify are book-level (resting orders only)
+  const OrderBook::Locator* loc = book_.loc_.find(c.order.id);
+  if (loc == nullptr) {
+    // Pending stops can be cancelled (not modified) before they are elected
+    Order gone{};
+    if (c.type == CommandType::Cancel && stops_.cancel(c.order.id, gone)) {
+      gone.ts = c.order.ts;
+      report_(ExecType::Cancel, gone, gone.qty, 0);
+      return ProcessStatus{};
+    }
+    if (const Order* peg = pegs_.find(c.order.id)) {
+      gone = *peg;
+      gone.ts = c.order.ts;
+      const bool ok = (c.type == CommandType::Cancel) ? pegs_.cancel(c.order.id, gone)
+                                                      : pegs_.reduce(c.order.id, c.order.qty);
+      if (!ok) return reject_(c.order, RejectReason::InvalidOrder);
+      const Qty left = (c.type == CommandType::Modify && c.order.qty > 0) ? c.order.qty : 0;
+      report_(ExecType::Cancel, gone, gone.qty - left, left);
+      return ProcessStatus{};
+    }
+    return reject_(c.order, RejectReason::UnknownOrder);
   }
 
-  // Restock leftover eligible LIMIT orders into continuous book
-  for (auto& b : buys) {
-    if (b.qty > 0 && b.type == OrderType::Limit) (void)book_.add_resting_limit(b);
-  }
-  for (auto& s : sells) {
-    if (s.qty > 0 && s.type == OrderType::Limit) (void)book_.add_resting_limit(s);
-  }
+  // Snapshot before the node is released
+  const RestingOrder& r = book_.orders_[loc->h];
+  ExecReport rep{r.id, r.owner, c.order.ts, 0, loc->price, book_.leaves_(loc->h), 0, instrument_, loc->side,
+                 ExecType::Cancel, RejectReason::None, true};
 
-  // Restock ineligible LIMIT orders (queued during auction but not executable at clearing price)
-  for (auto& o : auction_queue_) {
-    if (o.type != OrderType::Limit || o.qty <= 0) continue;
-    const bool eligible = (o.side == Side::Buy) ? (o.price >= clearing_px) : (o.price <= clearing_px);
-    if (!eligible) {
-      o.ts = uncross_ts;
-      (void)book_.add_resting_limit(o);
+  const bool ok = (c.type == CommandType::Cancel) ? book_.cancel(c.order.id)
+                                                  : book_.modify_qty(c.order.id, c.order.qty);
+  if (!ok) return reject_(c.order, RejectReason::InvalidOrder); // e.g. modify tried to increase
+
+  if (reports_on_) {
+    if (c.type == CommandType::Modify && c.order.qty > 0) {
+      rep.leaves = c.order.qty;
+      rep.qty -= c.order.qty;
     }
+    exec_.push(rep);
   }
 
-  auction_queue_.clear();
-  return trades;
+  // A wider lit spread lifts the caps that kept contra pegs apart
+  settle_peg_crosses_(c.order.ts, trades);
+  return ProcessStatus{};
 }
 
-MatchResult MatchingEngine::process(Order incoming) {
-  MatchResult out{};
+ProcessStatus MatchingEngine::reject_(const Order& o, RejectReason why) {
+  ProcessStatus st{};
+  st.status = OrderStatus::Rejected;
+  st.reject_reason = why;
+  report_(ExecType::Reject, o, o.qty, 0, why);
+  return st;
+}
 
-  // Finalize any due phase endings BEFORE processing this message
-  auto flushed = flush(incoming.ts);
-  out.trades.insert(out.trades.end(), flushed.begin(), flushed.end());
+// Message handling after flush; trades[first..] already holds anything flushed
+ProcessStatus MatchingEngine::process_(Order incoming, std::vector<Trade>& trades, std::size_t first) {
+  ProcessStatus st{};
 
   const auto decision = rules_.pre_accept(incoming);
-  if (!decision.accept) {
-    out.status = OrderStatus::Rejected;
-    out.reject_reason = decision.reason;
-    return out;
+  if (!decision.accept) return reject_(incoming, decision.reason);
+  if (incoming.tif == TimeInForce::GTD && incoming.expire_ts <= incoming.ts) {
+    return reject_(incoming, RejectReason::InvalidOrder); // already lapsed
   }
 
   // Closed: ignore everything
-  if (rules_.phase() == MarketPhase::Closed) return out;
+  if (rules_.phase() == MarketPhase::Closed) {
+    report_(ExecType::Expire, incoming, incoming.qty, 0);
+    return st;
+  }
+
+  // Pegs are resting-only and trade in continuous trading only
+  if (incoming.peg != PegType::None) {
+    if (!is_valid_order(incoming) || rules_.phase() != MarketPhase::Continuous) {
+      return reject_(incoming, RejectReason::InvalidOrder);
+    }
+    const Price tick = rules_.config().tick_size_ticks;
+    if (tick > 1 && incoming.peg_offset % tick != 0) return reject_(incoming, RejectReason::PriceNotOnTick);
+  }
+
+  // Stops wait in the trigger book until a print crosses them
+  if (incoming.stop_price > 0 && park_stop_(incoming, st)) return st;
+
+  // A peg has no price of its own yet: it never takes lit liquidity, so the
+  // band, FOK and auction checks below do not apply to it
+  if (incoming.peg != PegType::None) {
+    add_peg_(incoming, st);
+    cross_pegs_(incoming.ts, trades);
+    settle_(std::span<const Trade>(trades).subspan(first), st);
+    elect_stops_(std::span<const Trade>(trades).subspan(first), trades);
+    return st;
+  }
 
   // Circuit breaker halt: either reject or queue (depending on config), no matching
   if (rules_.phase() == MarketPhase::Halted) {
-    if (!rules_.config().queue_orders_during_halt) {
-      out.status = OrderStatus::Rejected;
-      out.reject_reason = RejectReason::MarketHalted;
-      return out;
-    }
-    (void)queue_in_auction(std::move(incoming));
-    return out;
+    if (!rules_.config().queue_orders_during_halt) return reject_(incoming, RejectReason::MarketHalted);
+    queue_in_auction(std::move(incoming));
+    return st;
   }
 
   // Trading-at-Last: only trade at last trade price
   if (rules_.phase() == MarketPhase::TradingAtLast) {
     const auto last = rules_.last_trade_price();
-    if (!last) {
-      out.status = OrderStatus::Rejected;
-      out.reject_reason = RejectReason::NoReferencePrice;
-      return out;
-    }
+    if (!last) return reject_(incoming, RejectReason::NoReferencePrice);
 
     if (incoming.type == OrderType::Limit && incoming.price != *last) {
-      out.status = OrderStatus::Rejected;
-      out.reject_reason = RejectReason::PriceNotAtLast;
-      return out;
+      return reject_(incoming, RejectReason::PriceNotAtLast);
     }
 
     incoming.type = OrderType::Limit;
     incoming.price = *last;
 
-    auto r = process_limit(std::move(incoming));
-    out.trades.insert(out.trades.end(), r.trades.begin(), r.trades.end());
-    out.resting = r.resting;
-
-    out.filled_qty = 0;
-    for (const auto& tr : out.trades) out.filled_qty += tr.qty;
-
-    rules_.on_trades(out.trades);
+    process_limit(std::move(incoming), trades, st);
     // CB only triggers in Continuous, so harmless here
-    maybe_trigger_circuit_breaker(out.trades);
-    return out;
+    settle_(std::span<const Trade>(trades).subspan(first), st);
+    elect_stops_(std::span<const Trade>(trades).subspan(first), trades);
+    return st;
   }
 
   // Auction phases: queue (flush handles expiry/uncross)
   if (rules_.phase() == MarketPhase::Auction || rules_.phase() == MarketPhase::ClosingAuction) {
-    (void)queue_in_auction(std::move(incoming));
-    return out;
+    queue_in_auction(std::move(incoming));
+    return st;
   }
 
   // Volatility trigger only in continuous
   if (should_trigger_volatility_auction(incoming)) {
     rules_.set_phase(MarketPhase::Auction);
     auction_end_ts_ = incoming.ts + rules_.config().vol_auction_duration_ns;
-    (void)queue_in_auction(std::move(incoming));
-    return out;
+    arm_(auction_end_ts_, TimerKind::AuctionEnd);
+    queue_in_auction(std::move(incoming));
+    return st;
   }
 
   // FOK pre-check
   if (incoming.tif == TimeInForce::FOK) {
     const Qty avail = available_liquidity(incoming);
     if (avail < incoming.qty) {
-      rules_.on_trades(out.trades);
-      maybe_trigger_circuit_breaker(out.trades);
-      return out;
+      report_(ExecType::Expire, incoming, incoming.qty, 0);
+      const auto flushed = std::span<const Trade>(trades).subspan(first);
+      rules_.on_trades(flushed);
+      maybe_trigger_circuit_breaker(flushed);
+      return st;
     }
   }
 
-  MatchResult r{};
-  if (incoming.type == OrderType::Market) r = process_market(std::move(incoming));
-  else r = process_limit(std::move(incoming));
+  const Ts ts = incoming.ts;
+  if (incoming.type == OrderType::Market) process_market(std::move(incoming), trades, st);
+  else process_limit(std::move(incoming), trades, st);
 
-  out.trades.insert(out.trades.end(), r.trades.begin(), r.trades.end());
-  out.resting = r.resting;
+  cross_pegs_(ts, trades); // the lit BBO may have moved under the pegs
+  settle_(std::span<const Trade>(trades).subspan(first), st);
+  elect_stops_(std::span<const Trade>(trades).subspan(first), trades);
+  return st;
+}
 
-  out.filled_qty = 0;
-  for (const auto& tr : out.trades) out.filled_qty += tr.qty;
+// ---- stops ----
 
-  rules_.on_trades(out.trades);
-  maybe_trigger_circuit_breaker(out.trades);
+// True if the order was parked (or rejected, with st set); false if the market
+// has already traded through its trigger, in which case it is elected on arrival
+bool MatchingEngine::park_stop_(Order& incoming, ProcessStatus& st) {
+  const Price tick = rules_.config().tick_size_ticks;
+  if (tick > 1 && incoming.stop_price % tick != 0) {
+    st = reject_(incoming, RejectReason::PriceNotOnTick);
+    return true;
+  }
 
-  return out;
+  ExecReport rep{incoming.id, incoming.owner, incoming.ts, 0, incoming.stop_price, incoming.qty,
+                 incoming.qty, instrument_, incoming.side, ExecType::StopPending, RejectReason::None, false};
+
+  const auto last = rules_.last_trade_price();
+  if (last && StopBook::crossed(incoming, *last)) {
+    if (reports_on_) { rep.type = ExecType::Triggered; exec_.push(rep); }
+    incoming.stop_price = 0;
+    return false;
+  }
+
+  if (!stops_.add(incoming)) {
+    st = reject_(incoming, RejectReason::InvalidOrder); // id already pending
+    return true;
+  }
+  if (reports_on_) exec_.push(rep);
+  track_expiry_(incoming);
+  return true;
 }
 
-MatchResult MatchingEngine::process_market(Order incoming) {
-  MatchResult out{};
-  if (incoming.qty <= 0) return out;
+// Elect the stops crossed by `prints` and feed them through the normal path.
+// Stops elected by those orders' own prints join the back of the worklist, so a
+// cascade runs breadth-first in election order (see StopBook::elect).
+void MatchingEngine::elect_stops_(std::span<const Trade> prints, std::vector<Trade>& trades) {
+  if (prints.empty() || stops_.empty()) return;
+
+  Price lo = prints.front().price;
+  Price hi = lo;
+  for (const auto& t : prints) {
+    lo = std::min(lo, t.price);
+    hi = std::max(hi, t.price);
+  }
+  const Ts ts = prints.back().ts; // prints may dangle once trades grows below
+
+  const std::size_t from = elected_.size();
+  stops_.elect(lo, hi, elected_);
+  for (std::size_t i = from; i < elected_.size(); ++i) {
+    Order& o = elected_[i];
+    if (reports_on_) {
+      exec_.push(ExecReport{o.id, o.owner, ts, 0, o.stop_price, o.qty, o.qty, instrument_, o.side,
+                            ExecType::Triggered, RejectReason::None, false});
+    }
+    o.ts = ts;
+    o.stop_price = 0;
+  }
+  if (electing_) return; // the outer call drains the worklist
 
-  if (incoming.side == Side::Buy) match_buy(out, incoming);
-  else match_sell(out, incoming);
+  electing_ = true;
+  for (std::size_t i = 0; i < elected_.size(); ++i) {
+    const Order o = elected_[i]; // elected_ may grow while o is processed
+    (void)process_(o, trades, trades.size());
+  }
+  elected_.clear();
+  electing_ = false;
+}
 
-  out.filled_qty = 0;
-  for (const auto& tr : out.trades) out.filled_qty += tr.qty;
+// ---- GTD expiry ----
+
+// Expire every GTD order whose deadline is at or before ts. Timers are never
+// removed early: one whose order already left (filled, cancelled) finds nothing.
+void MatchingEngine::expire_(Ts ts) {
+  expiries_.advance(ts, [&](OrderId id, Ts deadline) {
+    if (const OrderBook::Locator* loc = book_.loc_.find(id)) {
+      if (book_.cold_[loc->h].tif != TimeInForce::GTD) return;
+      const RestingOrder& r = book_.orders_[loc->h];
+      const ExecReport rep{r.id, r.owner, deadline, 0, loc->price, book_.leaves_(loc->h), 0, instrument_,
+                           loc->side, ExecType::Expire, RejectReason::None, true};
+      (void)book_.cancel(id);
+      if (reports_on_) exec_.push(rep);
+      return;
+    }
+    Order gone{};
+    if (stops_.cancel(id, gone) || pegs_.cancel(id, gone)) {
+      gone.ts = deadline;
+      report_(ExecType::Expire, gone, gone.qty, 0);
+    }
+  });
+}
 
-  if (incoming.mkt_style == MarketStyle::MarketToLimit && incoming.qty > 0 && !out.trades.empty()) {
-    Order rest = incoming;
-    rest.type = OrderType::Limit;
-    rest.price = out.trades.back().price;
-    rest.tif = TimeInForce::GTC;
-    rest.mkt_style = MarketStyle::PureMarket;
+// ---- pegs ----
 
-    if (book_.add_resting_limit(rest)) out.resting = rest;
+// Pegs never take lit liquidity (they are priced inside the spread), so an
+// arriving peg just rests; cross_pegs_ then pairs it with any contra peg.
+void MatchingEngine::add_peg_(const Order& incoming, ProcessStatus& st) {
+  if (!pegs_.add(incoming)) {
+    st = reject_(incoming, RejectReason::InvalidOrder); // id already resting
+    return;
   }
-
-  return out;
+  st.resting = incoming;
+  if (reports_on_) {
+    const auto px = PegBook::price_of(incoming.side, incoming.peg, incoming.peg_offset, book_.best_bid(),
+                                      book_.best_ask(), rules_.config().tick_size_ticks);
+    exec_.push(ExecReport{incoming.id, incoming.owner, incoming.ts, 0, px.value_or(0), incoming.qty,
+                          incoming.qty, instrument_, incoming.side, ExecType::New, RejectReason::None, false});
+  }
+  track_expiry_(incoming);
 }
 
-MatchResult MatchingEngine::process_limit(Order incoming) {
-  MatchResult out{};
-  if (incoming.qty <= 0) return out;
+// One fill of `taker` against the best contra peg at its resolved price. False if
+// self-trade prevention cancelled the taker.
+template <Side S, StpMode M>
+bool MatchingEngine::fill_peg_(std::vector<Trade>& trades, Order& taker, const Order& peg, Price px) {
+  constexpr Side contra = opposite(S);
+  if constexpr (M != StpMode::None) {
+    if (peg.owner == taker.owner) {
+      if constexpr (M == StpMode::CancelTaker) {
+        report_(ExecType::Cancel, taker, taker.qty, 0, RejectReason::SelfTradePrevented);
+        taker.qty = 0;
+        return false;
+      } else {
+        Order gone{};
+        (void)pegs_.cancel(peg.id, gone);
+        if (reports_on_) {
+          exec_.push(ExecReport{gone.id, gone.owner, taker.ts, 0, px, gone.qty, 0, instrument_, contra,
+                                ExecType::Cancel, RejectReason::SelfTradePrevented, true});
+        }
+        return true;
+      }
+    }
+  }
 
-  if (incoming.side == Side::Buy) match_buy(out, incoming);
-  else match_sell(out, incoming);
+  const Qty q = std::min(taker.qty, peg.qty);
+  const OrderId maker_id = peg.id;
+  const OwnerId maker_owner = peg.owner;
+  const Qty maker_left = peg.qty - q;
+  pegs_.fill(peg, q); // peg may be gone from here on
+
+  trades.push_back(make_trade(taker.ts, px, q, maker_id, taker.id));
+  taker.qty -= q;
+
+  if (reports_on_) {
+    const TradeId tid = trades.back().id;
+    exec_.push(ExecReport{maker_id, maker_owner, taker.ts, tid, px, q, maker_left, instrument_, contra,
+                          maker_left == 0 ? ExecType::Fill : ExecType::PartialFill, RejectReason::None, true});
+    exec_.push(ExecReport{taker.id, taker.owner, taker.ts, tid, px, q, taker.qty, instrument_, S,
+                          taker.qty == 0 ? ExecType::Fill : ExecType::PartialFill, RejectReason::None, false});
+  }
+  return true;
+}
 
-  out.filled_qty = 0;
-  for (const auto& tr : out.trades) out.filled_qty += tr.qty;
+// Pegs on both sides can cross each other when the lit spread is wide. Only the
+// two best pegs are resolved per step, so this is O(1) unless they actually trade.
+// The older order is the maker and sets the price.
+void MatchingEngine::cross_pegs_(Ts ts, std::vector<Trade>& trades) {
+  if (pegs_.empty(Side::Buy) || pegs_.empty(Side::Sell)) return;
+  if (rules_.phase() != MarketPhase::Continuous) return;
 
-  if (incoming.tif == TimeInForce::IOC) return out;
+  const auto bid = book_.best_bid();
+  const auto ask = book_.best_ask();
+  const Price tick = rules_.config().tick_size_ticks;
+  const StpMode stp = rules_.config().stp;
+
+  for (;;) {
+    Price bpx = 0;
+    Price spx = 0;
+    Order* b = pegs_.best(Side::Buy, bid, ask, tick, bpx);
+    Order* s = pegs_.best(Side::Sell, bid, ask, tick, spx);
+    if (b == nullptr || s == nullptr || bpx < spx) return;
+
+    const bool buy_rests = (b->ts < s->ts) || (b->ts == s->ts && b->id < s->id);
+    Order taker = buy_rests ? *s : *b;
+    const Order& maker = buy_rests ? *b : *s;
+    const Price px = buy_rests ? bpx : spx;
+    taker.ts = ts;
+
+    bool more = true;
+    if (taker.side == Side::Buy) {
+      switch (stp) {
+        case StpMode::None:        more = fill_peg_<Side::Buy, StpMode::None>(trades, taker, maker, px); break;
+        case StpMode::CancelTaker: more = fill_peg_<Side::Buy, StpMode::CancelTaker>(trades, taker, maker, px); break;
+        case StpMode::CancelMaker: more = fill_peg_<Side::Buy, StpMode::CancelMaker>(trades, taker, maker, px); break;
+      }
+    } else {
+      switch (stp) {
+        case StpMode::None:        more = fill_peg_<Side::Sell, StpMode::None>(trades, taker, maker, px); break;
+        case StpMode::CancelTaker: more = fill_peg_<Side::Sell, StpMode::CancelTaker>(trades, taker, maker, px); break;
+        case StpMode::CancelMaker: more = fill_peg_<Side::Sell, StpMode::CancelMaker>(trades, taker, maker, px); break;
+      }
+    }
 
-  if (incoming.qty > 0) {
-    if (book_.add_resting_limit(incoming)) out.resting = incoming;
+    // Write back what is left of the resting taker
+    Order gone{};
+    const Qty left = taker.qty;
+    if (!more || left == 0) (void)pegs_.cancel(taker.id, gone);
+    else (void)pegs_.reduce(taker.id, left);
   }
+}
 
-  return out;
+// Peg crosses outside a submit (timers, cancel/modify) settle like a submit's
+// own prints: rules, circuit breaker, then stop election
+void MatchingEngine::settle_peg_crosses_(Ts ts, std::vector<Trade>& trades) {
+  const std::size_t crossed = trades.size();
+  cross_pegs_(ts, trades);
+  if (trades.size() == crossed) return;
+  ProcessStatus st{};
+  settle_(std::span<const Trade>(trades).subspan(crossed), st);
+  elect_stops_(std::span<const Trade>(trades).subspan(crossed), trades);
 }
 
-void MatchingEngine::match_buy(MatchResult& out, Order& taker) {
-  while (taker.qty > 0 && !book_.asks_.empty()) {
-    auto best_it = book_.asks_.begin();
-    const Price best_ask_px = best_it->first;
+void MatchingEngine::process_market(Order incoming, std::vector<Trade>& trades, ProcessStatus& st) {
+  if (incoming.qty <= 0) return;
+  const std::size_t first = trades.size();
 
-    if (taker.type == OrderType::Limit && best_ask_px > taker.price) break;
+  match(trades, incoming);
 
-    auto& lvl = best_it->second;
-    if (lvl.q.empty()) {
-      book_.asks_.erase(best_it);
-      continue;
-    }
+  if (incoming.mkt_style == MarketStyle::MarketToLimit && incoming.qty > 0 && trades.size() > first) {
+    Order rest = incoming;
+    rest.type = OrderType::Limit;
+    rest.price = trades.back().price;
+    rest.tif = TimeInForce::GTC;
+    rest.mkt_style = MarketStyle::PureMarket;
 
-    if (rules_.config().stp != StpMode::None) {
-      const OwnerId maker_owner = lvl.q.front().owner;
-      if (maker_owner == taker.owner) {
-        if (rules_.config().stp == StpMode::CancelTaker) {
-          taker.qty = 0;
-          return;
-        }
-        const OrderId maker_id = lvl.q.front().id;
-        (void)book_.cancel(maker_id);
-        continue;
-      }
+    if (book_.add_resting_limit(rest)) {
+      st.resting = rest;
+      report_(ExecType::New, rest, rest.qty, rest.qty);
+      return;
     }
+  }
+  if (incoming.qty > 0) report_(ExecType::Expire, incoming, incoming.qty, 0);
+}
 
-    auto& maker = lvl.q.front();
-    const Qty q = std::min(taker.qty, maker.qty);
+void MatchingEngine::process_limit(Order incoming, std::vector<Trade>& trades, ProcessStatus& st) {
+  if (incoming.qty <= 0) return;
 
-    out.trades.push_back(make_trade(taker.ts, best_ask_px, q, maker.id, taker.id));
+  match(trades, incoming);
 
-    taker.qty -= q;
-    maker.qty -= q;
-    lvl.total_qty -= q;
+  if (incoming.qty <= 0) return;
+  if (incoming.tif == TimeInForce::IOC) {
+    report_(ExecType::Expire, incoming, incoming.qty, 0);
+    return;
+  }
 
-    if (maker.qty == 0) { book_.erase_locator(maker.id); lvl.q.pop_front(); }
-    if (lvl.total_qty == 0) book_.asks_.erase(best_it);
+  if (book_.add_resting_limit(incoming)) {
+    st.resting = incoming;
+    report_(ExecType::New, incoming, incoming.qty, incoming.qty);
+    track_expiry_(incoming);
   }
 }
 
-void MatchingEngine::match_sell(MatchResult& out, Order& taker) {
-  while (taker.qty > 0 && !book_.bids_.empty()) {
-    auto best_it = book_.bids_.begin();
-    const Price best_bid_px = best_it->first;
+template <Side S, OrderType T, StpMode M>
+void MatchingEngine::match_(std::vector<Trade>& trades, Order& taker) {
+  constexpr Side contra = opposite(S);
+  auto& ladder = [this]() -> auto& {
+    if constexpr (S == Side::Buy) return book_.asks_;
+    else return book_.bids_;
+  }();
+  const bool pegs_live = !pegs_.empty(contra) && rules_.phase() == MarketPhase::Continuous;
+
+  // Contra pegs are priced off the lit BBO the taker arrived at, not re-priced
+  // as the sweep eats into it: a peg at the touch waits behind lit at that price
+  // and then trades there, instead of sliding down with the levels it loses to.
+  const auto peg_bid = pegs_live ? book_.best_bid() : std::nullopt;
+  const auto peg_ask = pegs_live ? book_.best_ask() : std::nullopt;
+
+  while (taker.qty > 0) {
+    Price px = 0;
+    auto* best = ladder.best(px);
+
+    // Non-displayed, pegs only go ahead of lit interest at a better price
+    if (pegs_live) {
+      Price ppx = 0;
+      if (Order* peg = pegs_.best(contra, peg_bid, peg_ask, rules_.config().tick_size_ticks, ppx)) {
+        const bool in_limit = (T != OrderType::Limit) || !ladder.better(taker.price, ppx);
+        if (in_limit && (best == nullptr || ladder.better(ppx, px))) {
+          if (!fill_peg_<S, M>(trades, taker, *peg, ppx)) return;
+          continue;
+        }
+      }
+    }
+    if (best == nullptr) break;
 
-    if (taker.type == OrderType::Limit && best_bid_px < taker.price) break;
+    // Limit taker stops once its price is better than the contra level
+    if constexpr (T == OrderType::Limit) {
+      if (ladder.better(taker.price, px)) break;
+    }
 
-    auto& lvl = best_it->second;
+    auto& lvl = *best;
     if (lvl.q.empty()) {
-      book_.bids_.erase(best_it);
+      ladder.erase(px);
       continue;
     }
 
-    if (rules_.config().stp != StpMode::None) {
-      const OwnerId maker_owner = lvl.q.front().owner;
-      if (maker_owner == taker.owner) {
-        if (rules_.config().stp == StpMode::CancelTaker) {
+    const NodeHandle maker_h = lvl.q.front();
+    auto& maker = book_.orders_[maker_h];
+
+    if constexpr (M != StpMode::None) {
+      if (maker.owner == taker.owner) {
+        if constexpr (M == StpMode::CancelTaker) {
+          report_(ExecType::Cancel, taker, taker.qty, 0, RejectReason::SelfTradePrevented);
           taker.qty = 0;
           return;
+        } else {
+          if (reports_on_) {
+            exec_.push(ExecReport{maker.id, maker.owner, taker.ts, 0, px, book_.leaves_(maker_h), 0, instrument_,
+                                  contra, ExecType::Cancel, RejectReason::SelfTradePrevented, true});
+          }
+          (void)book_.cancel(maker.id);
+          continue;
         }
-        const OrderId maker_id = lvl.q.front().id;
-        (void)book_.cancel(maker_id);
-        continue;
       }
     }
 
-    auto& maker = lvl.q.front();
     const Qty q = std::min(taker.qty, maker.qty);
 
-    out.trades.push_back(make_trade(taker.ts, best_bid_px, q, maker.id, taker.id));
+    trades.push_back(make_trade(taker.ts, px, q, maker.id, taker.id));
 
     taker.qty -= q;
     maker.qty -= q;
     lvl.total_qty -= q;
 
-    if (maker.qty == 0) { book_.erase_locator(maker.id); lvl.q.pop_front(); }
-    if (lvl.total_qty == 0) book_.bids_.erase(best_it);
+    if (reports_on_) {
+      const TradeId tid = trades.back().id;
+      const Qty leaves = book_.leaves_(maker_h);
+      exec_.push(ExecReport{maker.id, maker.owner, taker.ts, tid, px, q, leaves, instrument_, contra,
+                            leaves == 0 ? ExecType::Fill : ExecType::PartialFill, RejectReason::None, true});
+      exec_.push(ExecReport{taker.id, taker.owner, taker.ts, tid, px, q, taker.qty, instrument_, S,
+                            taker.qty == 0 ? ExecType::Fill : ExecType::PartialFill, RejectReason::None, false});
+    }
+
+    if (maker.qty == 0 && !book_.replenish_(lvl, contra, px, maker_h, taker.ts)) {
+      book_.erase_locator(maker.id);
+      book_.remove_(lvl, maker_h);
+    }
+    if (lvl.total_qty == 0) ladder.erase(px);
+    book_.touch_(contra, px);
+  }
+}
+
+template <StpMode M>
+void MatchingEngine::match_stp_(std::vector<Trade>& trades, Order& taker) {
+  if (taker.side == Side::Buy) {
+    if (taker.type == OrderType::Limit) match_<Side::Buy, OrderType::Limit, M>(trades, taker);
+    else match_<Side::Buy, OrderType::Market, M>(trades, taker);
+  } else {
+    if (taker.type == OrderType::Limit) match_<Side::Sell, OrderType::Limit, M>(trades, taker);
+    else match_<Side::Sell, OrderType::Market, M>(trades, taker);
+  }
+}
+
+void MatchingEngine::match(std::vector<Trade>& trades, Order& taker) {
+  switch (rules_.config().stp) {
+    case StpMode::None:        match_stp_<StpMode::None>(trades, taker); break;
+    case StpMode::CancelTaker: match_stp_<StpMode::CancelTaker>(trades, taker); break;
+    case StpMode::CancelMaker: match_stp_<StpMode::CancelMaker>(trades, taker); break;
   }
 }
 
@@ -35,24 +35,34 @@ std::optional<OrderId> OrderFlowGenerator::sample_cancel_id() {
 
 std::vector<Event> OrderFlowGenerator::generate(Ts t0_ns, double horizon_seconds) {
   std::vector<Event> out;
-  const double horizon_ns = horizon_seconds * 1e9;
+  start(t0_ns, horizon_seconds);
+  Event e;
+  while (next(e)) out.push_back(e);
+  return out;
+}
 
-  double t = 0.0;
+void OrderFlowGenerator::start(Ts t0_ns, double horizon_seconds) {
+  t0_ = t0_ns;
+  t_ = 0.0;
+  horizon_ns_ = horizon_seconds * 1e9;
 
   // Start around a reference mid (ticks). Later we’ll adapt to book mid.
-  Price ref_mid = 10000; // 100.00 if tick=0.01
+  ref_mid_ = 10000;
+  live_ = t_ < horizon_ns_;
+}
 
-  while (t < horizon_ns) {
+bool OrderFlowGenerator::next(Event& out) {
+  while (live_) {
     // Next event time using combined intensity
     const double lambda_total = p_.lambda_limit + p_.lambda_market + p_.lambda_cancel;
     if (lambda_total <= 0.0) break;
 
     const double dt_sec = rng_.exp(lambda_total); // in seconds
     const double dt_ns = dt_sec * 1e9;
-    t += dt_ns;
-    if (t >= horizon_ns) break;
+    t_ += dt_ns;
+    if (t_ >= horizon_ns_) break;
 
-    const Ts ts = t0_ns + static_cast<Ts>(t);
+    const Ts ts = t0_ + static_cast<Ts>(t_);
 
     // Choose event type by mixture
     const double u = rng_.uniform01() * lambda_total;
@@ -60,19 +70,24 @@ std::vector<Event> OrderFlowGenerator::generate(Ts t0_ns, double horizon_seconds
     if (u < p_.lambda_limit) {
       Side side = sample_side();
       Qty qty = sample_qty();
-      Price px = limit_price_around(ref_mid, side);
-      out.push_back(AddLimit{next_id_++, ts, side, px, qty, /*owner*/ 1});
+      Price px = limit_price_around(ref_mid_, side);
+      out = AddLimit{next_id_++, ts, side, px, qty, /*owner*/ 1};
+      return true;
     } else if (u < p_.lambda_limit + p_.lambda_market) {
       Side side = sample_side();
       Qty qty = sample_qty();
-      out.push_back(AddMarket{next_id_++, ts, side, qty, /*owner*/ 2});
+      out = AddMarket{next_id_++, ts, side, qty, /*owner*/ 2};
+      return true;
     } else {
       auto id = sample_cancel_id();
-      if (id) out.push_back(Cancel{*id, ts});
+      if (id) {
+        out = Cancel{*id, ts};
+        return true;
+      }
     }
   }
-
-  return out;
+  live_ = false;
+  return false;
 }
 
 } // namespace msim
@@ -0,0 +1,278 @@
+// Max-speed replay of a recorded journal (see msim/journal.hpp).
+//
+// Memory-maps the file, decodes input records straight into Command batches and
+// feeds them to one MatchingEngine per instrument: no Event variants, no per-event
+// BookTop. Reports throughput, per-message latency percentiles and a hash of the
+// final state (trades + books + phases), and checks the replayed fills against
+// the ones recorded in the journal. Each instrument's engine is built from the
+// rules and book setup journaled when it was attached.
+//
+// usage: msim_replay <journal> [--no-verify] [--no-latency] [--chunk N]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "msim/journal.hpp"
+#include "msim/matching_engine.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Hasher {
+  uint64_t h{0xCBF2'9CE4'8422'2325ull};
+  void add(uint64_t v) noexcept { h = (h ^ v) * 0x100'0000'01B3ull; }
+};
+
+void hash_trade(Hasher& hs, msim::Ts ts, uint64_t id, msim::Price px, msim::Qty q, uint64_t maker, uint64_t taker,
+                msim::InstrumentId inst) {
+  hs.add(static_cast<uint64_t>(ts));
+  hs.add(id);
+  hs.add(static_cast<uint64_t>(static_cast<uint32_t>(px)));
+  hs.add(static_cast<uint64_t>(static_cast<uint32_t>(q)));
+  hs.add(maker);
+  hs.add(taker);
+  hs.add(inst);
+}
+
+// Session-started phases are the only phase records that are inputs: flush never
+// enters TradingAtLast or ClosingAuction on its own
+bool is_session_input(const msim::JournalRecord& r) noexcept {
+  if (r.kind != msim::JournalKind::Phase) return false;
+  const auto to = static_cast<msim::MarketPhase>(r.f0);
+  return to == msim::MarketPhase::TradingAtLast || to == msim::MarketPhase::ClosingAuction;
+}
+
+bool is_input(const msim::JournalRecord& r) noexcept {
+  return r.kind == msim::JournalKind::Command || r.kind == msim::JournalKind::Reject;
+}
+
+class Replayer {
+public:
+  explicit Replayer(std::size_t expected_trades) { trades_.reserve(expected_trades); }
+
+  void run(std::span<const msim::Command> cmds) {
+    std::size_t i = 0;
+    while (i < cmds.size()) {
+      const msim::InstrumentId id = cmds[i].instrument();
+      std::size_t j = i + 1;
+      while (j < cmds.size() && cmds[j].instrument() == id) ++j;
+      (void)engine_(id).process_batch(cmds.subspan(i, j - i), trades_);
+      i = j;
+    }
+  }
+
+  // Setup applies to an instrument until its engine first runs
+  void configure(const msim::JournalRecord& r) {
+    if (r.instrument >= setups_.size()) setups_.resize(static_cast<std::size_t>(r.instrument) + 1);
+    msim::to_config(r, setups_[r.instrument].rules, setups_[r.instrument].book);
+  }
+
+  void session(const msim::JournalRecord& r) {
+    auto& eng = engine_(r.instrument);
+    if (static_cast<msim::MarketPhase>(r.f0) == msim::MarketPhase::TradingAtLast) eng.start_trading_at_last(r.ts);
+    else eng.start_closing_auction(r.ts);
+  }
+
+  const std::vector<msim::Trade>& trades() const noexcept { return trades_; }
+
+  uint64_t fills_hash() const noexcept {
+    Hasher hs;
+    for (const auto& t : trades_) {
+      hash_trade(hs, t.ts, t.id, t.price, t.qty, t.maker_order_id, t.taker_order_id, t.instrument);
+    }
+    return hs.h;
+  }
+
+  // Fills plus every instrument's phase and full depth
+  uint64_t state_hash() const {
+    Hasher hs;
+    hs.add(fills_hash());
+    for (const auto& e : engines_) {
+      if (!e) {
+        hs.add(0);
+        continue;
+      }
+      hs.add(static_cast<uint64_t>(e->rules().phase()) + 1);
+      for (msim::Side s : {msim::Side::Buy, msim::Side::Sell}) {
+        for (const auto& lvl : e->book().depth(s, e->book().level_count(s))) {
+          hs.add(static_cast<uint64_t>(static_cast<uint32_t>(lvl.price)));
+          hs.add(static_cast<uint64_t>(static_cast<uint32_t>(lvl.total_qty)));
+          hs.add(lvl.order_count);
+        }
+        hs.add(0xFFFF'FFFF'FFFF'FFFFull);
+      }
+    }
+    return hs.h;
+  }
+
+private:
+  struct Setup {
+    msim::RulesConfig rules{};
+    msim::BookConfig book{};
+  };
+
+  std::vector<std::unique_ptr<msim::MatchingEngine>> engines_{};
+  std::vector<Setup> setups_{};
+  std::vector<msim::Trade> trades_{};
+
+  msim::MatchingEngine& engine_(msim::InstrumentId id) {
+    if (id >= engines_.size()) engines_.resize(static_cast<std::size_t>(id) + 1);
+    if (!engines_[id]) {
+      const Setup setup = (id < setups_.size()) ? setups_[id] : Setup{};
+      engines_[id] = std::make_unique<msim::MatchingEngine>(msim::RuleSet{setup.rules}, setup.book);
+      engines_[id]->set_instrument(id);
+    }
+    return *engines_[id];
+  }
+};
+
+double percentile(std::vector<uint32_t>& v, double q) {
+  if (v.empty()) return 0.0;
+  const auto k = static_cast<std::size_t>(q * static_cast<double>(v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+  return static_cast<double>(v[k]);
+}
+
+const char* to_cstr(msim::JournalStatus s) noexcept {
+  switch (s) {
+    case msim::JournalStatus::Ok: return "ok";
+    case msim::JournalStatus::UnsealedTail: return "unsealed tail";
+    case msim::JournalStatus::BadChecksum: return "bad checksum";
+    case msim::JournalStatus::SequenceGap: return "sequence gap";
+    case msim::JournalStatus::BadHeader: return "bad header";
+    case msim::JournalStatus::IoError: return "i/o error";
+  }
+  return "?";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: msim_replay <journal> [--no-verify] [--no-latency] [--chunk N]\n");
+    return 2;
+  }
+  const std::string path = argv[1];
+  bool verify = true;
+  bool latency = true;
+  std::size_t chunk = 4096;
+  for (int i = 2; i < argc; ++i) {
+    const std::string a = argv[i];
+    if (a == "--no-verify") verify = false;
+    else if (a == "--no-latency") latency = false;
+    else if (a == "--chunk" && i + 1 < argc) chunk = std::max<std::size_t>(1, std::stoull(argv[++i]));
+  }
+
+  msim::MappedJournal journal;
+  if (const auto st = journal.open(path); st != msim::JournalStatus::Ok) {
+    std::fprintf(stderr, "msim_replay: %s: %s\n", path.c_str(), to_cstr(st));
+    return 1;
+  }
+
+  auto records = journal.records();
+  if (verify) {
+    const auto scan = msim::verify_journal(records);
+    std::printf("journal: %zu records, %s, replaying %zu verified\n", records.size(), to_cstr(scan.status),
+                scan.verified);
+    records = records.first(scan.verified);
+  } else {
+    std::printf("journal: %zu records (not verified)\n", records.size());
+  }
+
+  // Recorded fills: what the replay must reproduce
+  std::size_t inputs = 0;
+  Hasher recorded;
+  std::size_t recorded_fills = 0;
+  for (const auto& r : records) {
+    if (is_input(r)) ++inputs;
+    if (r.kind == msim::JournalKind::Fill) {
+      hash_trade(recorded, r.ts, r.b, r.price, r.qty, r.id, r.a, r.instrument);
+      ++recorded_fills;
+    }
+  }
+
+  // ---- throughput pass: decode straight from the map into reused batches ----
+  Replayer fast(recorded_fills);
+  std::vector<msim::Command> batch;
+  batch.reserve(chunk);
+
+  const auto t0 = Clock::now();
+  for (const auto& r : records) {
+    if (is_input(r)) {
+      batch.push_back(msim::to_command(r));
+      if (batch.size() == chunk) {
+        fast.run(batch);
+        batch.clear();
+      }
+    } else if (is_session_input(r)) {
+      fast.run(batch);
+      batch.clear();
+      fast.session(r);
+    } else if (r.kind == msim::JournalKind::Config) {
+      fast.run(batch);
+      batch.clear();
+      fast.configure(r);
+    }
+  }
+  fast.run(batch);
+  const auto t1 = Clock::now();
+
+  const double secs = std::chrono::duration<double>(t1 - t0).count();
+  std::printf("messages: %zu  trades: %zu  time: %.3f s  throughput: %.2f M msg/s  (%.1f ns/msg)\n", inputs,
+              fast.trades().size(), secs, static_cast<double>(inputs) / secs / 1e6,
+              secs * 1e9 / static_cast<double>(std::max<std::size_t>(inputs, 1)));
+
+  const bool fills_match = fast.trades().size() == recorded_fills && fast.fills_hash() == recorded.h;
+  std::printf("fills vs journal: %s\n", fills_match ? "match" : "MISMATCH");
+
+  const uint64_t state = fast.state_hash();
+  std::printf("state hash: %016llx\n", static_cast<unsigned long long>(state));
+
+  // ---- latency pass: one message at a time, timed individually ----
+  if (latency) {
+    Replayer slow(recorded_fills);
+    std::vector<uint32_t> ns;
+    ns.reserve(inputs);
+
+    // Cost of the timer pair itself, subtracted from each sample
+    std::vector<uint32_t> empty(1024);
+    for (auto& e : empty) {
+      const auto a = Clock::now();
+      const auto b = Clock::now();
+      e = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+    }
+    const auto overhead = static_cast<uint32_t>(percentile(empty, 0.5));
+
+    for (const auto& r : records) {
+      if (is_input(r)) {
+        const msim::Command c = msim::to_command(r);
+        const auto a = Clock::now();
+        slow.run(std::span<const msim::Command>(&c, 1));
+        const auto b = Clock::now();
+        const auto d = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+        ns.push_back(d > overhead ? d - overhead : 0);
+      } else if (is_session_input(r)) {
+        slow.session(r);
+      } else if (r.kind == msim::JournalKind::Config) {
+        slow.configure(r);
+      }
+    }
+
+    std::printf("latency ns (timer overhead %u ns removed): p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  max %.0f\n",
+                overhead, percentile(ns, 0.50), percentile(ns, 0.90), percentile(ns, 0.99), percentile(ns, 0.999),
+                percentile(ns, 1.0));
+    if (slow.state_hash() != state) {
+      std::printf("state hash MISMATCH between batched and per-message replay\n");
+      return 1;
+    }
+  }
+
+  return fills_match ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include "msim/result_sink.hpp"
+
+namespace msim {
+
+namespace {
+void put(std::ofstream& f, const std::optional<Price>& px) {
+  if (px) f << *px;
+}
+} // namespace
+
+bool CsvSink::open(const std::string& prefix, unsigned streams) {
+  streams_ = streams;
+  bool good = true;
+  if (streams & kSinkTrades) {
+    trades_.open(prefix + "trades.csv");
+    trades_ << "trade_id,ts,price,qty,maker_id,taker_id\n";
+    good = good && trades_.good();
+  }
+  if (streams & kSinkTops) {
+    tops_.open(prefix + "top.csv");
+    tops_ << "ts,best_bid,best_ask,mid\n";
+    good = good && tops_.good();
+  }
+  if (streams & kSinkRejects) {
+    rejects_.open(prefix + "rejects.csv");
+    rejects_ << "ts,order_id,owner,type,reason\n";
+    good = good && rejects_.good();
+  }
+  if (streams & kSinkAccounts) {
+    accounts_.open(prefix + "accounts.csv");
+    accounts_ << "ts,owner,cash_ticks,position,mtm_ticks\n";
+    good = good && accounts_.good();
+  }
+  return good;
+}
+
+bool CsvSink::ok() const noexcept {
+  return (!(streams_ & kSinkTrades) || trades_.good()) && (!(streams_ & kSinkTops) || tops_.good()) &&
+         (!(streams_ & kSinkRejects) || rejects_.good()) && (!(streams_ & kSinkAccounts) || accounts_.good());
+}
+
+void CsvSink::on_trades(std::span<const Trade> ts) {
+  CountingSink::on_trades(ts);
+  if (!(streams_ & kSinkTrades)) return;
+  for (const auto& t : ts) {
+    trades_ << t.id << "," << t.ts << "," << t.price << "," << t.qty << ","
+            << t.maker_order_id << "," << t.taker_order_id << "\n";
+  }
+}
+
+void CsvSink::on_top(const BookTop& t) {
+  CountingSink::on_top(t);
+  if (!(streams_ & kSinkTops)) return;
+  tops_ << t.ts << ",";
+  put(tops_, t.best_bid);
+  tops_ << ",";
+  put(tops_, t.best_ask);
+  tops_ << ",";
+  put(tops_, t.mid);
+  tops_ << "\n";
+}
+
+void CsvSink::on_reject(const RejectRecord& r) {
+  CountingSink::on_reject(r);
+  if (!(streams_ & kSinkRejects)) return;
+  rejects_ << r.ts << "," << r.id << "," << r.owner << "," << static_cast<int>(r.type) << ","
+           << static_cast<int>(r.reason) << "\n";
+}
+
+void CsvSink::on_accounts(std::span<const AccountSnapshot> as) {
+  CountingSink::on_accounts(as);
+  if (!(streams_ & kSinkAccounts)) return;
+  for (const auto& a : as) {
+    accounts_ << a.ts << "," << a.owner << "," << a.cash_ticks << "," << a.position << ","
+              << a.mtm_ticks << "\n";
+  }
+}
+
+void CsvSink::flush() {
+  if (trades_.is_open()) trades_.flush();
+  if (tops_.is_open()) tops_.flush();
+  if (rejects_.is_open()) rejects_.flush();
+  if (accounts_.is_open()) accounts_.flush();
+}
+
+} // namespace msim
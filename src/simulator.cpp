@@ -2,6 +2,7 @@
 #include "msim/invariants.hpp"
 
 #include <algorithm>
+#include <span>
 #include <utility>
 
 namespace msim {
@@ -21,53 +22,119 @@ inline BookTop make_top(Ts ts, const OrderBook& b) {
   t.mid = midprice(t.best_bid, t.best_ask);
   return t;
 }
+
+Command command_of(const Event& e) noexcept {
+  return std::visit([](const auto& x) {
+    using T = std::decay_t<decltype(x)>;
+
+    if constexpr (std::is_same_v<T, AddLimit>) {
+      return Command::submit(Order{x.id, x.ts, x.side, OrderType::Limit, x.price, x.qty, x.owner});
+    } else if constexpr (std::is_same_v<T, AddMarket>) {
+      return Command::submit(Order{x.id, x.ts, x.side, OrderType::Market, 0, x.qty, x.owner});
+    } else if constexpr (std::is_same_v<T, Cancel>) {
+      return Command::cancel(x.id, x.ts);
+    } else {
+      return Command::modify(x.id, x.new_qty, x.ts);
+    }
+  }, e);
+}
+
+constexpr std::size_t kChunk = 4096;
+
+// Stable (ts, insertion order) view of an unordered batch; sorts pointers, not events
+class SortedView final : public EventSource {
+public:
+  explicit SortedView(std::span<const Event> events) {
+    order_.reserve(events.size());
+    for (uint64_t i = 0; i < events.size(); ++i) {
+      const auto& e = events[i];
+      order_.push_back(TimedEvent{ts_of(e), i, &e});
+    }
+
+    std::stable_sort(order_.begin(), order_.end(),
+                     [](const TimedEvent& a, const TimedEvent& b) {
+                       if (a.ts != b.ts) return a.ts < b.ts;
+                       return a.seq < b.seq;
+                     });
+  }
+
+  bool next(Event& out) override {
+    if (at_ == order_.size()) return false;
+    out = *order_[at_++].ev;
+    return true;
+  }
+  bool time_ordered() const noexcept override { return true; }
+
+private:
+  std::vector<TimedEvent> order_{};
+  std::size_t at_{0};
+};
 } // namespace
 
-SimulationResult Simulator::run(const std::vector<Event>& events) {
-  SimulationResult out{};
+void Simulator::run(EventSource& src, ResultSink& sink) {
+  if (src.time_ordered()) {
+    pump_(src, sink);
+    return;
+  }
+
+  // Has to be sorted, so it has to be in memory
+  std::vector<Event> events;
+  Event e;
+  while (src.next(e)) events.push_back(e);
+  SortedView sorted(events);
+  pump_(sorted, sink);
+}
 
-  std::vector<TimedEvent> sorted;
-  sorted.reserve(events.size());
-  for (uint64_t i = 0; i < events.size(); ++i) {
-    const auto& e = events[i];
-    Ts ts = 0;
-    std::visit([&](const auto& x) { ts = x.ts; }, e);
-    sorted.push_back(TimedEvent{ts, i, &e});
+void Simulator::run(const std::vector<Event>& events, ResultSink& sink) {
+  SpanSource src(events);
+  if (src.time_ordered()) {
+    pump_(src, sink);
+    return;
   }
+  SortedView sorted(events);
+  pump_(sorted, sink);
+}
+
+// Pulls a time-ordered source in fixed-size chunks: the scratch vectors stay
+// bounded however long the replay is, and output starts after the first chunk
+void Simulator::pump_(EventSource& src, ResultSink& sink) {
+  const unsigned want = sink.streams();
+  std::vector<Command> cmds;
+  std::vector<Trade> trades;
+  cmds.reserve(kChunk);
+
+  const auto on_done = [&](const Command& c, const ProcessStatus& st, std::span<const Trade> fills) {
+    if ((want & kSinkTrades) && !fills.empty()) sink.on_trades(fills);
+    if ((want & kSinkRejects) && st.status == OrderStatus::Rejected) {
+      sink.on_reject(RejectRecord{c.order.ts, c.order.id, c.order.owner, c.type, st.reject_reason});
+    }
+    if (want & kSinkTops) sink.on_top(make_top(c.order.ts, engine_.book()));
+  };
 
-  std::stable_sort(sorted.begin(), sorted.end(),
-                   [](const TimedEvent& a, const TimedEvent& b) {
-                     if (a.ts != b.ts) return a.ts < b.ts;
-                     return a.seq < b.seq;
-                   });
-
-  for (const auto& te : sorted) {
-    const auto& e = *te.ev;
-
-    std::visit([&](const auto& x) {
-      using T = std::decay_t<decltype(x)>;
-
-      if constexpr (std::is_same_v<T, AddLimit>) {
-        Order o{x.id, x.ts, x.side, OrderType::Limit, x.price, x.qty, x.owner};
-        auto res = engine_.process(o);
-        out.trades.insert(out.trades.end(), res.trades.begin(), res.trades.end());
-        out.tops.push_back(make_top(x.ts, engine_.book()));
-      } else if constexpr (std::is_same_v<T, AddMarket>) {
-        Order o{x.id, x.ts, x.side, OrderType::Market, 0, x.qty, x.owner};
-        auto res = engine_.process(o);
-        out.trades.insert(out.trades.end(), res.trades.begin(), res.trades.end());
-        out.tops.push_back(make_top(x.ts, engine_.book()));
-      } else if constexpr (std::is_same_v<T, Cancel>) {
-        // cancel is book-level (resting orders)
-        if (!engine_.book_mut().cancel(x.id)) out.cancel_failures++;
-        out.tops.push_back(make_top(x.ts, engine_.book()));
-      } else if constexpr (std::is_same_v<T, Modify>) {
-        if (!engine_.book_mut().modify(x.id, x.new_qty)) out.modify_failures++;
-        out.tops.push_back(make_top(x.ts, engine_.book()));
-      }
-    }, e);
+  Event e;
+  bool more = true;
+  while (more) {
+    cmds.clear();
+    while (cmds.size() < kChunk && (more = src.next(e))) cmds.push_back(command_of(e));
+    if (cmds.empty()) break;
+
+    trades.clear();
+    (void)engine_.process_batch(cmds, trades, on_done);
   }
+  sink.flush();
+}
+
+SimulationResult Simulator::run(const std::vector<Event>& events) {
+  MemorySink mem;
+  run(events, mem);
 
+  SimulationResult out{};
+  out.trades = std::move(mem.trades);
+  out.tops = std::move(mem.tops);
+  for (const auto& r : mem.rejects) {
+    if (r.type == CommandType::Cancel) out.cancel_failures++;
+    else if (r.type == CommandType::Modify) out.modify_failures++;
+  }
   return out;
 }
 
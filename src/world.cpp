@@ -1,6 +1,7 @@
 #include "msim/world.hpp"
 #include <algorithm>
 #include <cmath>
+#include <span>
 
 namespace msim {
 
@@ -11,9 +12,7 @@ uint64_t World::splitmix64(uint64_t& x) noexcept {
   return z ^ (z >> 31);
 }
 
-WorldResult World::run(uint64_t seed, double horizon_seconds, WorldConfig cfg) {
-  WorldResult out{};
-
+void World::run(uint64_t seed, double horizon_seconds, ResultSink& sink, WorldConfig cfg) {
   const Ts t0 = 0;
   const Ts t_end = static_cast<Ts>(std::llround(horizon_seconds * 1'000'000'000.0));
 
@@ -24,18 +23,23 @@ WorldResult World::run(uint64_t seed, double horizon_seconds, WorldConfig cfg) {
     agents_[i]->seed(s);
   }
 
+  const unsigned want = sink.streams();
+  std::vector<Action> actions;
+  std::vector<Command> cmds;
+  std::vector<Trade> trades; // one step's prints, handed to the sink and reused
+  actions.reserve(8);
+  cmds.reserve(8);
+
+  const auto emit_trades = [&] {
+    if ((want & kSinkTrades) && !trades.empty()) sink.on_trades(trades);
+    trades.clear();
+  };
+
   for (Ts ts = t0; ts <= t_end; ts += cfg.dt_ns) {
     // flush timed phase transitions / auctions etc
-    {
-      auto flushed = engine_.flush(ts);
-      if (!flushed.empty()) {
-        out.trades.insert(out.trades.end(), flushed.begin(), flushed.end());
-        auto bb = engine_.book().best_bid();
-        auto ba = engine_.book().best_ask();
-        auto mid = midprice(bb, ba);
-        apply_trades_to_accounts(ts, flushed, order_meta_, accounts_, mid);
-      }
-    }
+    (void)engine_.flush(ts, trades);
+    apply_exec_reports(engine_.exec_reports(), accounts_);
+    emit_trades();
 
     const auto bb = engine_.book().best_bid();
     const auto ba = engine_.book().best_ask();
@@ -47,8 +51,10 @@ WorldResult World::run(uint64_t seed, double horizon_seconds, WorldConfig cfg) {
     view.best_ask = ba;
     view.mid = mid;
     view.last_trade = engine_.rules().last_trade_price();
+    view.indicative = engine_.indicative_auction();
 
-    // per-agent actions in insertion order (deterministic)
+    // per-agent actions in insertion order (deterministic); each agent's actions
+    // go to the engine as one batch so the next agent sees its fills in `self`
     for (auto& ap : agents_) {
       const OwnerId oid = ap->owner();
 
@@ -60,51 +66,66 @@ WorldResult World::run(uint64_t seed, double horizon_seconds, WorldConfig cfg) {
         self.position = it->second.position;
       }
 
-      std::vector<Action> actions;
-      actions.reserve(8);
+      actions.clear();
       ap->step(ts, view, self, actions);
 
+      cmds.clear();
       for (const auto& act : actions) {
         if (act.type == ActionType::Submit) {
           Order o = act.order;
           o.ts = ts;
-
-          // record meta BEFORE processing (so taker side/owner is known)
-          order_meta_[o.id] = OrderMeta{o.owner, o.side};
-
-          auto res = engine_.process(o);
-          if (!res.trades.empty()) {
-            out.trades.insert(out.trades.end(), res.trades.begin(), res.trades.end());
-            const auto bb2 = engine_.book().best_bid();
-            const auto ba2 = engine_.book().best_ask();
-            const auto mid2 = midprice(bb2, ba2);
-            apply_trades_to_accounts(ts, res.trades, order_meta_, accounts_, mid2);
-          }
+          cmds.push_back(Command::submit(o));
         } else if (act.type == ActionType::Cancel) {
-          if (!engine_.book_mut().cancel(act.id)) out.cancel_failures++;
+          cmds.push_back(Command::cancel(act.id, ts));
         } else {
-          if (!engine_.book_mut().modify_qty(act.id, act.new_qty)) out.modify_failures++;
+          cmds.push_back(Command::modify(act.id, act.new_qty, ts));
         }
       }
+
+      (void)engine_.process_batch(cmds, trades,
+                                  [&](const Command& c, const ProcessStatus& st, std::span<const Trade>) {
+        if ((want & kSinkRejects) && st.status == OrderStatus::Rejected) {
+          sink.on_reject(RejectRecord{c.order.ts, c.order.id, oid, c.type, st.reject_reason});
+        }
+      });
+      apply_exec_reports(engine_.exec_reports(), accounts_);
+      emit_trades();
     }
 
     // record top-of-book
-    BookTop top{};
-    top.ts = ts;
-    top.best_bid = engine_.book().best_bid();
-    top.best_ask = engine_.book().best_ask();
-    top.mid = midprice(top.best_bid, top.best_ask);
-    out.tops.push_back(top);
+    if (want & kSinkTops) {
+      BookTop top{};
+      top.ts = ts;
+      top.best_bid = engine_.book().best_bid();
+      top.best_ask = engine_.book().best_ask();
+      top.mid = midprice(top.best_bid, top.best_ask);
+      sink.on_top(top);
+    }
   }
 
   // final account snapshots at end
-  {
+  if (want & kSinkAccounts) {
     const auto bb = engine_.book().best_bid();
     const auto ba = engine_.book().best_ask();
     const auto mid = midprice(bb, ba);
-    out.accounts = make_account_snapshots(t_end, accounts_, mid);
+    const auto snaps = make_account_snapshots(t_end, accounts_, mid);
+    sink.on_accounts(snaps);
   }
+  sink.flush();
+}
 
+WorldResult World::run(uint64_t seed, double horizon_seconds, WorldConfig cfg) {
+  MemorySink mem;
+  run(seed, horizon_seconds, mem, cfg);
+
+  WorldResult out{};
+  out.trades = std::move(mem.trades);
+  out.tops = std::move(mem.tops);
+  out.accounts = std::move(mem.accounts);
+  for (const auto& r : mem.rejects) {
+    if (r.type == CommandType::Cancel) out.cancel_failures++;
+    else if (r.type == CommandType::Modify) out.modify_failures++;
+  }
   return out;
 }
 
@@ -40,3 +40,52 @@ TEST(Agents, NoiseTraderWorldRunsDeterministically) {
   EXPECT_EQ(r1.trades.size(), r2.trades.size());
   EXPECT_EQ(r1.tops.size(), r2.tops.size());
 }
+
+TEST(Agents, AccountsSettleFromExecReportsWithBoundedState) {
+  msim::RulesConfig cfg{};
+  msim::MatchingEngine eng{msim::RuleSet(cfg)};
+  msim::World w{std::move(eng)};
+
+  msim::agents::NoiseTraderConfig ntcfg{};
+  w.add_agent(std::make_unique<msim::agents::NoiseTrader>(msim::OwnerId{1}, ntcfg));
+  msim::MarketMakerParams mp{};
+  w.add_agent(std::make_unique<msim::MarketMaker>(msim::OwnerId{2}, cfg, mp));
+
+  auto r = w.run(7, 60.0);
+  ASSERT_FALSE(r.trades.empty());
+
+  // Every print is between the two agents: cash and inventory net to zero
+  int64_t cash = 0, pos = 0, traded = 0;
+  for (const auto& a : r.accounts) {
+    cash += a.cash_ticks;
+    pos += a.position;
+  }
+  for (const auto& t : r.trades) traded += t.qty;
+  EXPECT_EQ(cash, 0);
+  EXPECT_EQ(pos, 0);
+  EXPECT_GT(traded, 0);
+
+  // Reports are drained every step, so the ring only ever holds one burst
+  EXPECT_TRUE(w.engine_mut().exec_reports().empty());
+  EXPECT_LE(w.engine_mut().exec_reports().capacity(), 1024u);
+}
+
+TEST(Agents, GtdQuotesLapseWithoutCancelTraffic) {
+  msim::RulesConfig cfg{};
+  msim::MatchingEngine eng{msim::RuleSet(cfg)};
+  msim::World w{std::move(eng)};
+
+  msim::MarketMakerParams mp{};
+  mp.gtd_quotes = true;
+  w.add_agent(std::make_unique<msim::MarketMaker>(msim::OwnerId{2}, cfg, mp));
+
+  (void)w.run(3, 1.0);
+
+  // Only the latest pair of quotes is still resting; older ones expired in place
+  const auto& book = w.engine_mut().book();
+  for (const msim::Side s : {msim::Side::Buy, msim::Side::Sell}) {
+    uint32_t resting = 0;
+    for (const auto& lvl : book.depth(s, 32)) resting += lvl.order_count;
+    EXPECT_EQ(resting, 1u);
+  }
+}
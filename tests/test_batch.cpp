@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <variant>
+#include <vector>
+
+#include "msim/matching_engine.hpp"
+#include "msim/order_flow.hpp"
+#include "msim/simulator.hpp"
+
+namespace {
+msim::Order limit(msim::OrderId id, msim::Ts ts, msim::Side s, msim::Price px, msim::Qty q, msim::OwnerId owner = 1) {
+  return msim::Order{id, ts, s, msim::OrderType::Limit, px, q, owner};
+}
+} // namespace
+
+TEST(ProcessBatch, MixedCommandsReportPerCommandOutcome) {
+  msim::MatchingEngine eng;
+
+  const std::vector<msim::Command> cmds{
+      msim::Command::submit(limit(1, 10, msim::Side::Sell, 105, 5)),
+      msim::Command::submit(limit(2, 10, msim::Side::Sell, 106, 5)),
+      msim::Command::modify(2, 3, 11),
+      msim::Command::cancel(99, 11), // never rested
+      msim::Command::submit(limit(3, 12, msim::Side::Buy, 106, 7, 2)),
+      msim::Command::cancel(1, 13),  // already filled
+  };
+
+  std::vector<std::size_t> fills_per_cmd;
+  std::vector<msim::RejectReason> reasons;
+  std::vector<msim::Trade> trades;
+  const std::size_t n = eng.process_batch(cmds, trades,
+      [&](const msim::Command&, const msim::ProcessStatus& st, std::span<const msim::Trade> fills) {
+        fills_per_cmd.push_back(fills.size());
+        reasons.push_back(st.reject_reason);
+      });
+
+  ASSERT_EQ(n, 2u);
+  EXPECT_EQ(trades[0].price, 105);
+  EXPECT_EQ(trades[0].qty, 5);
+  EXPECT_EQ(trades[1].price, 106);
+  EXPECT_EQ(trades[1].qty, 2); // modify reduced the 106 ask to 3
+
+  EXPECT_EQ(fills_per_cmd, (std::vector<std::size_t>{0, 0, 0, 0, 2, 0}));
+  EXPECT_EQ(reasons[2], msim::RejectReason::None);
+  EXPECT_EQ(reasons[3], msim::RejectReason::UnknownOrder);
+  EXPECT_EQ(reasons[5], msim::RejectReason::UnknownOrder);
+  EXPECT_EQ(*eng.book().best_ask(), 106);
+  EXPECT_EQ(eng.book().depth(msim::Side::Sell, 1)[0].total_qty, 1);
+}
+
+TEST(ProcessBatch, DueAuctionUncrossesAheadOfFirstCommandAtThatTs) {
+  msim::MatchingEngine eng;
+  eng.start_closing_auction(100);
+
+  const std::vector<msim::Command> queue{
+      msim::Command::submit(limit(1, 50, msim::Side::Sell, 100, 4)),
+      msim::Command::submit(limit(2, 50, msim::Side::Buy, 101, 4, 2)),
+  };
+  std::vector<msim::Trade> trades;
+  EXPECT_EQ(eng.process_batch(queue, trades), 0u);
+
+  // Uncross is attributed to the first command at ts >= end, and only once
+  std::vector<std::size_t> fills_per_cmd;
+  const std::vector<msim::Command> after{
+      msim::Command::cancel(7, 100),
+      msim::Command::cancel(8, 100),
+  };
+  (void)eng.process_batch(after, trades,
+      [&](const msim::Command&, const msim::ProcessStatus&, std::span<const msim::Trade> fills) {
+        fills_per_cmd.push_back(fills.size());
+      });
+
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].qty, 4);
+  EXPECT_EQ(fills_per_cmd, (std::vector<std::size_t>{1, 0}));
+}
+
+TEST(ProcessBatch, SimulatorMatchesMessageAtATimeReplay) {
+  msim::OrderFlowGenerator gen(7, msim::FlowParams{});
+  const auto events = gen.generate(0, 20.0);
+
+  msim::Simulator sim;
+  const auto res = sim.run(events);
+
+  // Reference: one message at a time (events are generated in time order)
+  msim::MatchingEngine ref;
+  std::vector<msim::Trade> trades;
+  uint32_t cancel_failures = 0;
+  for (const auto& e : events) {
+    std::visit([&](const auto& x) {
+      using T = std::decay_t<decltype(x)>;
+      if constexpr (std::is_same_v<T, msim::AddLimit>) {
+        (void)ref.process(msim::Order{x.id, x.ts, x.side, msim::OrderType::Limit, x.price, x.qty, x.owner}, trades);
+      } else if constexpr (std::is_same_v<T, msim::AddMarket>) {
+        (void)ref.process(msim::Order{x.id, x.ts, x.side, msim::OrderType::Market, 0, x.qty, x.owner}, trades);
+      } else if constexpr (std::is_same_v<T, msim::Cancel>) {
+        if (!ref.book_mut().cancel(x.id)) ++cancel_failures;
+      } else {
+        (void)ref.book_mut().modify_qty(x.id, x.new_qty);
+      }
+    }, e);
+  }
+
+  ASSERT_EQ(res.trades.size(), trades.size());
+  for (std::size_t i = 0; i < trades.size(); ++i) {
+    EXPECT_EQ(res.trades[i].price, trades[i].price);
+    EXPECT_EQ(res.trades[i].qty, trades[i].qty);
+    EXPECT_EQ(res.trades[i].maker_order_id, trades[i].maker_order_id);
+  }
+  EXPECT_EQ(res.cancel_failures, cancel_failures);
+  EXPECT_EQ(res.tops.size(), events.size());
+  EXPECT_EQ(sim.engine().book().best_bid(), ref.book().best_bid());
+  EXPECT_EQ(sim.engine().book().best_ask(), ref.book().best_ask());
+}
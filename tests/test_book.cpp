@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "msim/book.hpp"
+#include "msim/order_pool.hpp"
 
 TEST(OrderBook, EmptyInitially) {
   msim::OrderBook ob;
@@ -59,3 +60,20 @@ TEST(OrderBook, RejectCrossingRestingOrders) {
   EXPECT_EQ(*ob.best_ask(), 105);
 }
 
+
+TEST(OrderBook, RestingRecordsStayCompact) {
+  static_assert(sizeof(msim::RestingOrder) <= 32);
+  static_assert(sizeof(msim::RestingCold) <= 4);
+
+  msim::OrderBook ob{msim::BookConfig{1, 64, 1000}};
+  for (msim::OrderId i = 1; i <= 1000; ++i) {
+    EXPECT_TRUE(ob.add_resting_limit(msim::Order{i, 1, msim::Side::Buy, msim::OrderType::Limit,
+                                                 100 - static_cast<msim::Price>(i % 10), 1, 1}));
+  }
+  const auto m = ob.memory_usage();
+  EXPECT_EQ(m.live_orders, 1000u);
+  // Hot nodes plus cold table undercut a pool of full Orders of the same capacity
+  using FullPool = msim::SlabPool<msim::Order>;
+  EXPECT_LT(m.order_nodes + m.cold, FullPool::kSlabSize * sizeof(FullPool::Node));
+  EXPECT_GT(m.locator, 0u);
+}
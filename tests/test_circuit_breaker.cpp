@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include "msim/matching_engine.hpp"
+
+namespace {
+msim::Order lim(msim::OrderId id, msim::Ts ts, msim::Side side, msim::Price px, msim::Qty q, msim::OwnerId owner) {
+  return msim::Order{id, ts, side, msim::OrderType::Limit, px, q, owner};
+}
+msim::Order mkt(msim::OrderId id, msim::Ts ts, msim::Side side, msim::Qty q, msim::OwnerId owner) {
+  return msim::Order{id, ts, side, msim::OrderType::Market, 0, q, owner};
+}
+} // namespace
+
+TEST(CircuitBreaker, FrozenBookUncrossesInPlace) {
+  msim::RulesConfig cfg{};
+  cfg.enable_price_bands = false;
+  cfg.enable_volatility_interruption = false;
+  cfg.cb_drop_bps = 2500;
+  cfg.cb_halt_duration_ns = 10;
+  cfg.cb_reopen_auction_duration_ns = 10;
+  msim::MatchingEngine eng{msim::RuleSet{cfg}};
+
+  // Reference trade at 1000
+  (void)eng.process(lim(1, 1, msim::Side::Sell, 1000, 1, 2));
+  (void)eng.process(mkt(2, 2, msim::Side::Buy, 1, 3));
+
+  (void)eng.process(lim(10, 3, msim::Side::Buy, 990, 5, 3));
+  (void)eng.process(lim(11, 3, msim::Side::Buy, 990, 5, 3));
+  (void)eng.process(lim(12, 3, msim::Side::Buy, 700, 5, 3));
+  (void)eng.process(lim(13, 3, msim::Side::Buy, 600, 5, 3));
+  (void)eng.process(lim(20, 4, msim::Side::Sell, 1010, 5, 4));
+  (void)eng.process(lim(21, 4, msim::Side::Sell, 1020, 5, 4));
+
+  // Sweeping down to 700 breaches the 25% drop: halt with the book left in place
+  (void)eng.process(mkt(30, 100, msim::Side::Sell, 15, 5));
+  ASSERT_EQ(eng.rules().phase(), msim::MarketPhase::Halted);
+  EXPECT_EQ(eng.book().level_count(msim::Side::Buy), 1u);
+  EXPECT_EQ(eng.book().level_count(msim::Side::Sell), 2u);
+  EXPECT_FALSE(eng.indicative_auction().has_value());
+
+  // Interest queued during the halt crosses the frozen asks
+  (void)eng.process(lim(40, 105, msim::Side::Buy, 1015, 7, 6));
+  auto ind = eng.indicative_auction();
+  ASSERT_TRUE(ind.has_value());
+  EXPECT_EQ(ind->price, 1010); // plateau 1010..1015, nearest to last trade 700
+  EXPECT_EQ(ind->matched_qty, 5);
+  EXPECT_EQ(ind->imbalance, 2);
+
+  // Edits to the frozen book show up in the indicative state
+  EXPECT_TRUE(eng.book_mut().modify_qty(20, 3));
+  ind = eng.indicative_auction();
+  ASSERT_TRUE(ind.has_value());
+  EXPECT_EQ(ind->matched_qty, 3);
+  EXPECT_EQ(ind->imbalance, 4);
+
+  (void)eng.flush(110);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::Auction);
+  const auto trades = eng.flush(120);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::Continuous);
+
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].price, 1010);
+  EXPECT_EQ(trades[0].qty, 3);
+  EXPECT_EQ(trades[0].maker_order_id, 20u);
+  EXPECT_EQ(trades[0].taker_order_id, 40u);
+
+  // Residual: queued buy rests at 1015, untouched book orders are still there
+  EXPECT_FALSE(eng.book().is_crossed());
+  EXPECT_EQ(*eng.book().best_bid(), 1015);
+  EXPECT_EQ(*eng.book().best_ask(), 1020);
+  EXPECT_TRUE(eng.book_mut().cancel(13));
+  EXPECT_TRUE(eng.book_mut().cancel(21));
+  EXPECT_FALSE(eng.indicative_auction().has_value());
+}
+
+TEST(CircuitBreaker, FrozenBookKeepsTimePriorityAheadOfQueuedOrders) {
+  msim::RulesConfig cfg{};
+  cfg.enable_price_bands = false;
+  cfg.enable_volatility_interruption = false;
+  cfg.cb_halt_duration_ns = 10;
+  cfg.cb_reopen_auction_duration_ns = 10;
+  msim::MatchingEngine eng{msim::RuleSet{cfg}};
+
+  (void)eng.process(lim(1, 1, msim::Side::Sell, 1000, 1, 2));
+  (void)eng.process(mkt(2, 2, msim::Side::Buy, 1, 3));
+  (void)eng.process(lim(10, 3, msim::Side::Buy, 700, 1, 3));
+  (void)eng.process(lim(11, 4, msim::Side::Sell, 800, 4, 4)); // frozen, rested first
+  (void)eng.process(mkt(30, 100, msim::Side::Sell, 1, 5));    // trade at 700 -> halt
+  ASSERT_EQ(eng.rules().phase(), msim::MarketPhase::Halted);
+
+  (void)eng.process(lim(40, 101, msim::Side::Sell, 800, 4, 6)); // same price, queued later
+  (void)eng.process(lim(41, 102, msim::Side::Buy, 800, 6, 7));
+
+  (void)eng.flush(110);
+  const auto trades = eng.flush(120);
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[0].maker_order_id, 11u);
+  EXPECT_EQ(trades[0].qty, 4);
+  EXPECT_EQ(trades[1].maker_order_id, 40u);
+  EXPECT_EQ(trades[1].qty, 2);
+  EXPECT_EQ(eng.book().depth(msim::Side::Sell, 1).at(0).total_qty, 2);
+}
+
+TEST(CircuitBreaker, FrozenBookFeedSurvivesMove) {
+  msim::RulesConfig cfg{};
+  cfg.enable_price_bands = false;
+  cfg.enable_volatility_interruption = false;
+  cfg.cb_halt_duration_ns = 10;
+  cfg.cb_reopen_auction_duration_ns = 10;
+  msim::MatchingEngine eng{msim::RuleSet{cfg}};
+
+  (void)eng.process(lim(1, 1, msim::Side::Sell, 1000, 1, 2));
+  (void)eng.process(mkt(2, 2, msim::Side::Buy, 1, 3));
+  (void)eng.process(lim(10, 3, msim::Side::Buy, 700, 1, 3));
+  (void)eng.process(lim(11, 4, msim::Side::Sell, 800, 4, 4));
+  (void)eng.process(mkt(30, 100, msim::Side::Sell, 1, 5)); // trade at 700 -> halt
+  ASSERT_EQ(eng.rules().phase(), msim::MarketPhase::Halted);
+  (void)eng.process(lim(40, 101, msim::Side::Buy, 800, 6, 7));
+
+  // Frozen-book edits after a move still reach the curve that uncrosses them
+  msim::MatchingEngine moved(std::move(eng));
+  EXPECT_TRUE(moved.book_mut().modify_qty(11, 1));
+  ASSERT_TRUE(moved.indicative_auction().has_value());
+  EXPECT_EQ(moved.indicative_auction()->matched_qty, 1);
+
+  (void)moved.flush(110);
+  const auto trades = moved.flush(120);
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].maker_order_id, 11u);
+  EXPECT_EQ(trades[0].qty, 1);
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "msim/auction_curve.hpp"
+#include "msim/invariants.hpp"
+#include "msim/matching_engine.hpp"
+#include "msim/rng.hpp"
+
+namespace {
+
+// Reference implementation: every candidate price re-scans the whole queue
+std::optional<msim::Price> brute_clearing_price(const std::vector<msim::Order>& q, std::optional<msim::Price> ref) {
+  std::set<msim::Price> candidates;
+  for (const auto& o : q) {
+    if (o.type == msim::OrderType::Limit) candidates.insert(o.price);
+  }
+  if (candidates.empty()) return std::nullopt;
+
+  auto volume_at = [&](msim::Price px) {
+    msim::Qty buy = 0, sell = 0;
+    for (const auto& o : q) {
+      const bool mkt = (o.type == msim::OrderType::Market);
+      if (o.side == msim::Side::Buy && (mkt || o.price >= px)) buy += o.qty;
+      if (o.side == msim::Side::Sell && (mkt || o.price <= px)) sell += o.qty;
+    }
+    return std::min(buy, sell);
+  };
+
+  msim::Qty best_vol = -1;
+  msim::Price best_px = *candidates.begin();
+  for (msim::Price px : candidates) {
+    const msim::Qty v = volume_at(px);
+    if (v > best_vol) {
+      best_vol = v;
+      best_px = px;
+    } else if (v == best_vol && ref && std::abs(px - *ref) < std::abs(best_px - *ref)) {
+      best_px = px;
+    }
+  }
+  if (best_vol <= 0) return std::nullopt;
+  return best_px;
+}
+
+msim::Order random_order(msim::Rng& rng, msim::OrderId id, msim::Price lo, msim::Price hi, msim::Price tick) {
+  msim::Order o{id, static_cast<msim::Ts>(id), rng.uniform_int(0, 1) ? msim::Side::Buy : msim::Side::Sell,
+                msim::OrderType::Limit, rng.uniform_int(lo / tick, hi / tick) * tick, rng.uniform_int(1, 5), 1};
+  if (rng.uniform_int(0, 9) == 0) o.type = msim::OrderType::Market;
+  return o;
+}
+
+} // namespace
+
+TEST(ClearingPrice, CurvesMatchBruteForceIncludingTies) {
+  msim::RulesConfig rcfg{};
+  rcfg.enable_price_bands = false;
+  rcfg.enable_volatility_interruption = false;
+  rcfg.enable_circuit_breaker = false;
+
+  msim::Rng rng(17);
+  for (int round = 0; round < 200; ++round) {
+    msim::MatchingEngine eng{msim::RuleSet{rcfg}};
+
+    // Half the rounds have a mid reference from a wide resting market
+    std::optional<msim::Price> ref;
+    if (round % 2 == 0) {
+      EXPECT_TRUE(eng.book_mut().add_resting_limit(msim::Order{1, 0, msim::Side::Buy, msim::OrderType::Limit, 50, 1, 9}));
+      EXPECT_TRUE(eng.book_mut().add_resting_limit(msim::Order{2, 0, msim::Side::Sell, msim::OrderType::Limit, 150 + round % 7, 1, 9}));
+      ref = msim::midprice(eng.book().best_bid(), eng.book().best_ask());
+    }
+    eng.start_closing_auction(1000);
+
+    std::vector<msim::Order> queued;
+    const int n = rng.uniform_int(1, 40);
+    for (int i = 0; i < n; ++i) {
+      msim::Order o{static_cast<msim::OrderId>(10 + i), i + 1,
+                    rng.uniform_int(0, 1) ? msim::Side::Buy : msim::Side::Sell,
+                    msim::OrderType::Limit, rng.uniform_int(90, 110), rng.uniform_int(1, 5), 1};
+      if (rng.uniform_int(0, 9) == 0) o.type = msim::OrderType::Market;
+      queued.push_back(o);
+      (void)eng.process(o);
+    }
+
+    const auto expect = brute_clearing_price(queued, ref);
+    const auto trades = eng.flush(1000);
+    if (!expect) {
+      EXPECT_TRUE(trades.empty()) << "round " << round;
+    } else {
+      ASSERT_FALSE(trades.empty()) << "round " << round;
+      EXPECT_EQ(trades.front().price, *expect) << "round " << round;
+    }
+  }
+}
+
+TEST(ClearingPrice, IncrementalCurveTracksEveryQueuedOrder) {
+  msim::Rng rng(3);
+  for (int round = 0; round < 50; ++round) {
+    const msim::Price tick = (round % 3 == 0) ? 5 : 1;
+    msim::AuctionCurve curve(tick);
+    std::vector<msim::Order> queued;
+    std::optional<msim::Price> ref;
+    if (round % 2 == 0) ref = 1000 + 5 * rng.uniform_int(-20, 20);
+
+    // Later orders land far outside the initial window to force regrowth
+    for (msim::OrderId id = 1; id <= 60; ++id) {
+      const msim::Price spread = (id < 30) ? 100 : 5000;
+      const auto o = random_order(rng, id, 1000 - spread, 1000 + spread, tick);
+      queued.push_back(o);
+      curve.add(o.side, o.type, o.price, o.qty);
+
+      const auto expect = brute_clearing_price(queued, ref);
+      const auto got = curve.indicative(ref);
+      ASSERT_TRUE(curve.exact());
+      ASSERT_EQ(got.has_value(), expect.has_value()) << "round " << round << " id " << id;
+      if (expect) {
+        ASSERT_EQ(got->price, *expect) << "round " << round << " id " << id;
+      }
+    }
+  }
+}
+
+TEST(ClearingPrice, EngineIndicativeMatchesUncrossAndFallsBack) {
+  msim::RulesConfig rcfg{};
+  rcfg.enable_price_bands = false;
+  rcfg.enable_volatility_interruption = false;
+  rcfg.enable_circuit_breaker = false;
+
+  // Second case spreads prices wider than the curve window: full-pass fallback
+  for (msim::Price far : {msim::Price{120}, msim::Price{5'000'000}}) {
+    msim::MatchingEngine eng{msim::RuleSet{rcfg}};
+    eng.start_closing_auction(100);
+    EXPECT_FALSE(eng.indicative_auction().has_value());
+
+    (void)eng.process(msim::Order{1, 1, msim::Side::Buy, msim::OrderType::Limit, 101, 4, 1});
+    (void)eng.process(msim::Order{2, 2, msim::Side::Sell, msim::OrderType::Limit, 99, 3, 2});
+    (void)eng.process(msim::Order{3, 3, msim::Side::Sell, msim::OrderType::Limit, far, 9, 2});
+    (void)eng.process(msim::Order{4, 4, msim::Side::Sell, msim::OrderType::Limit, 100, 5, 2});
+
+    // Demand at 100 is 4, supply 8: 4 matched, 4 surplus sell
+    const auto ind = eng.indicative_auction();
+    ASSERT_TRUE(ind.has_value());
+    EXPECT_EQ(ind->price, 100);
+    EXPECT_EQ(ind->matched_qty, 4);
+    EXPECT_EQ(ind->imbalance, -4);
+
+    const auto trades = eng.flush(100);
+    ASSERT_FALSE(trades.empty());
+    EXPECT_EQ(trades.front().price, ind->price);
+    EXPECT_FALSE(eng.indicative_auction().has_value());
+  }
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "msim/agents/market_view.hpp"
+#include "msim/matching_engine.hpp"
+#include "msim/rng.hpp"
+
+namespace {
+// Reference depth computed by walking the book
+std::vector<msim::LevelSummary> walk(const msim::OrderBook& ob, msim::Side side) {
+  return ob.depth(side, msim::DepthImage::kCapacity + 1); // beyond capacity -> full walk
+}
+
+void expect_image_matches(const msim::OrderBook& ob, msim::Side side) {
+  const auto ref = walk(ob, side);
+  const auto img = ob.depth_image(side).view();
+  const std::size_t n = std::min<std::size_t>(ref.size(), msim::DepthImage::kCapacity);
+  ASSERT_EQ(img.size(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(img[i].price, ref[i].price);
+    EXPECT_EQ(img[i].total_qty, ref[i].total_qty);
+    EXPECT_EQ(img[i].order_count, ref[i].order_count);
+  }
+}
+} // namespace
+
+TEST(DepthImage, VersionOnlyMovesWhenTopLevelsChange) {
+  msim::OrderBook ob;
+  EXPECT_TRUE(ob.add_resting_limit(msim::Order{1, 1, msim::Side::Buy, msim::OrderType::Limit, 100, 5, 1}));
+
+  const auto v0 = ob.depth_image(msim::Side::Buy).version;
+  const auto a0 = ob.depth_image(msim::Side::Sell).version;
+
+  EXPECT_TRUE(ob.add_resting_limit(msim::Order{2, 2, msim::Side::Buy, msim::OrderType::Limit, 100, 3, 1}));
+  EXPECT_GT(ob.depth_image(msim::Side::Buy).version, v0);
+  EXPECT_EQ(ob.depth_image(msim::Side::Sell).version, a0); // other side untouched
+
+  const auto img = ob.depth_image(msim::Side::Buy).view();
+  ASSERT_EQ(img.size(), 1u);
+  EXPECT_EQ(img[0].total_qty, 8);
+  EXPECT_EQ(img[0].order_count, 2u);
+}
+
+TEST(DepthImage, TracksBookThroughAddsCancelsAndSweeps) {
+  msim::RulesConfig rcfg{};
+  rcfg.enable_price_bands = false;
+  rcfg.enable_volatility_interruption = false;
+  rcfg.enable_circuit_breaker = false;
+  msim::MatchingEngine eng{msim::RuleSet{rcfg}};
+  msim::Rng rng(5);
+
+  std::vector<msim::OrderId> live;
+  msim::OrderId id = 1;
+  for (int step = 0; step < 5000; ++step) {
+    const msim::Ts ts = step;
+    const double u = rng.uniform01();
+    const auto side = (rng.uniform01() < 0.5) ? msim::Side::Buy : msim::Side::Sell;
+
+    if (u < 0.6 || live.empty()) {
+      const msim::Price off = rng.uniform_int(1, 60);
+      const msim::Price px = (side == msim::Side::Buy) ? 1000 - off : 1000 + off;
+      (void)eng.process(msim::Order{id, ts, side, msim::OrderType::Limit, px, rng.uniform_int(1, 9), 1});
+      live.push_back(id++);
+    } else if (u < 0.7) {
+      (void)eng.process(msim::Order{id++, ts, side, msim::OrderType::Market, 0, rng.uniform_int(1, 60), 2});
+    } else {
+      const auto k = static_cast<std::size_t>(rng.uniform_int(0, static_cast<int32_t>(live.size() - 1)));
+      (void)eng.book_mut().cancel(live[k]);
+      live[k] = live.back();
+      live.pop_back();
+    }
+
+    expect_image_matches(eng.book(), msim::Side::Buy);
+    expect_image_matches(eng.book(), msim::Side::Sell);
+  }
+}
+
+TEST(DepthImage, AgentViewCopiesTopLevels) {
+  msim::OrderBook ob;
+  for (msim::OrderId i = 1; i <= 40; ++i) {
+    const auto px = static_cast<msim::Price>(100 - i);
+    EXPECT_TRUE(ob.add_resting_limit(msim::Order{i, 1, msim::Side::Buy, msim::OrderType::Limit, px, 1, 1}));
+  }
+  EXPECT_TRUE(ob.add_resting_limit(msim::Order{50, 1, msim::Side::Sell, msim::OrderType::Limit, 105, 3, 1}));
+
+  const auto none = msim::agents::make_view(ob, 7);
+  EXPECT_TRUE(none.bid_depth().empty());
+
+  const auto v = msim::agents::make_view(ob, 7, 3);
+  ASSERT_EQ(v.bid_depth().size(), 3u);
+  EXPECT_EQ(v.bid_depth()[0].price, 99);
+  EXPECT_EQ(v.bid_depth()[2].price, 97);
+  ASSERT_EQ(v.ask_depth().size(), 1u);
+  EXPECT_EQ(v.ask_depth()[0].total_qty, 3);
+
+  // Capped at the image capacity; the snapshot outlives later book changes
+  const auto deep = msim::agents::make_view(ob, 8, 100);
+  EXPECT_EQ(deep.bid_depth().size(), msim::DepthImage::kCapacity);
+  EXPECT_TRUE(ob.cancel(1));
+  EXPECT_EQ(deep.bid_depth()[0].price, 99);
+  expect_image_matches(ob, msim::Side::Buy);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+#include "msim/matching_engine.hpp"
+
+namespace {
+
+msim::Order limit(msim::OrderId id, msim::Ts ts, msim::Side s, msim::Price px, msim::Qty q) {
+  return msim::Order{id, ts, s, msim::OrderType::Limit, px, q, id};
+}
+
+} // namespace
+
+TEST(EngineTimers, IdleEngineHasNoDeadline) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+  EXPECT_EQ(eng.next_deadline(), std::numeric_limits<msim::Ts>::max());
+
+  (void)eng.process(limit(1, 5, msim::Side::Buy, 100, 1), trades);
+  EXPECT_EQ(eng.next_deadline(), std::numeric_limits<msim::Ts>::max());
+
+  msim::Order gtd = limit(2, 6, msim::Side::Buy, 99, 1);
+  gtd.tif = msim::TimeInForce::GTD;
+  gtd.expire_ts = 500;
+  (void)eng.process(gtd, trades);
+  EXPECT_EQ(eng.next_deadline(), 500);
+
+  eng.start_closing_auction(300);
+  EXPECT_EQ(eng.next_deadline(), 300);
+  EXPECT_EQ(eng.flush(299, trades), 0u);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::ClosingAuction);
+
+  (void)eng.flush(300, trades);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::Closed);
+  EXPECT_GT(eng.next_deadline(), 300); // the GTD timer is still pending
+  EXPECT_LE(eng.next_deadline(), 500);
+}
+
+TEST(EngineTimers, ScheduledSessionRunsFromMessageFlow) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+  (void)eng.process(limit(1, 1, msim::Side::Sell, 100, 5), trades);
+  (void)eng.process(limit(2, 2, msim::Side::Buy, 100, 1), trades); // last = 100
+
+  eng.schedule_trading_at_last(10, 20);
+  eng.schedule_closing_auction(20, 30);
+  EXPECT_EQ(eng.next_deadline(), 10);
+
+  // No explicit flush: each message's own flush fires what is due
+  const auto off_last = eng.process(limit(3, 12, msim::Side::Buy, 99, 1), trades);
+  EXPECT_EQ(off_last.reject_reason, msim::RejectReason::PriceNotAtLast);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::TradingAtLast);
+
+  (void)eng.process(limit(4, 25, msim::Side::Buy, 100, 2), trades); // queued in the close
+  (void)eng.process(limit(5, 26, msim::Side::Sell, 100, 2), trades);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::ClosingAuction);
+
+  const std::size_t before = trades.size();
+  (void)eng.flush(40, trades);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::Closed);
+  ASSERT_EQ(trades.size(), before + 1);
+  EXPECT_EQ(trades.back().ts, 30);
+}
+
+TEST(EngineTimers, MissedSessionWindowIsSkipped) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+  eng.schedule_trading_at_last(10, 20);
+
+  (void)eng.flush(25, trades);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::Continuous);
+  EXPECT_EQ(eng.next_deadline(), std::numeric_limits<msim::Ts>::max());
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "msim/event_source.hpp"
+#include "msim/order_flow.hpp"
+#include "msim/result_sink.hpp"
+#include "msim/simulator.hpp"
+
+namespace {
+
+std::vector<msim::Event> drain(msim::EventSource& src) {
+  std::vector<msim::Event> out;
+  msim::Event e;
+  while (src.next(e)) out.push_back(e);
+  return out;
+}
+
+void expect_same_trades(const std::vector<msim::Trade>& a, const std::vector<msim::Trade>& b) {
+  ASSERT_EQ(a.size(), b.size());
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(a[i].ts, b[i].ts);
+    EXPECT_EQ(a[i].price, b[i].price);
+    EXPECT_EQ(a[i].qty, b[i].qty);
+    EXPECT_EQ(a[i].maker_order_id, b[i].maker_order_id);
+    EXPECT_EQ(a[i].taker_order_id, b[i].taker_order_id);
+  }
+}
+
+} // namespace
+
+TEST(EventSources, GeneratorSourceMatchesGenerate) {
+  msim::OrderFlowGenerator gen(11, msim::FlowParams{});
+  const auto events = gen.generate(0, 5.0);
+
+  msim::GeneratorSource src(11, msim::FlowParams{}, 0, 5.0);
+  EXPECT_TRUE(src.time_ordered());
+  EXPECT_EQ(drain(src), events);
+}
+
+TEST(EventSources, StreamedRunMatchesVectorRun) {
+  msim::OrderFlowGenerator gen(5, msim::FlowParams{});
+  const auto events = gen.generate(0, 200.0); // spans several chunks
+
+  msim::Simulator a;
+  msim::MemorySink from_vec;
+  a.run(events, from_vec);
+
+  msim::Simulator b;
+  msim::GeneratorSource src(5, msim::FlowParams{}, 0, 200.0);
+  msim::MemorySink from_src;
+  b.run(src, from_src);
+
+  expect_same_trades(from_vec.trades, from_src.trades);
+  EXPECT_EQ(from_vec.tops.size(), events.size());
+  EXPECT_EQ(from_src.tops.size(), events.size());
+  EXPECT_EQ(from_vec.rejects.size(), from_src.rejects.size());
+}
+
+TEST(EventSources, FileRoundTripKeepsOrderFlag) {
+  const std::string ordered_path = ::testing::TempDir() + "msim_events_ordered.bin";
+  const std::string unordered_path = ::testing::TempDir() + "msim_events_unordered.bin";
+
+  msim::OrderFlowGenerator gen(3, msim::FlowParams{});
+  const auto events = gen.generate(0, 100.0);
+  {
+    msim::EventFileWriter w(ordered_path);
+    ASSERT_TRUE(w.is_open());
+    for (const auto& e : events) w.write(e);
+    w.close();
+    EXPECT_TRUE(w.ok());
+  }
+  {
+    msim::EventFileWriter w(unordered_path);
+    w.write(msim::AddLimit{1, 20, msim::Side::Sell, 101, 4, 1});
+    w.write(msim::Modify{1, 30, 2});
+    w.write(msim::AddMarket{2, 10, msim::Side::Buy, 1, 2});
+  }
+
+  msim::EventFileReader r(ordered_path);
+  ASSERT_TRUE(r.ok());
+  EXPECT_TRUE(r.time_ordered());
+  EXPECT_EQ(drain(r), events);
+  EXPECT_TRUE(r.ok());
+
+  msim::EventFileReader u(unordered_path);
+  ASSERT_TRUE(u.ok());
+  EXPECT_FALSE(u.time_ordered());
+  const auto back = drain(u);
+  ASSERT_EQ(back.size(), 3u);
+  EXPECT_EQ(std::get<msim::Modify>(back[1]).new_qty, 2);
+
+  // An unordered file is sorted before it runs: the market order finds no liquidity
+  msim::EventFileReader u2(unordered_path);
+  msim::Simulator sim;
+  msim::CountingSink counts;
+  sim.run(u2, counts);
+  EXPECT_EQ(counts.trades, 0u);
+  EXPECT_EQ(counts.tops, 3u);
+
+  // A torn last record: the whole records still come back, but ok() reports it
+  const std::string torn_path = ::testing::TempDir() + "msim_events_torn.bin";
+  std::filesystem::copy_file(unordered_path, torn_path, std::filesystem::copy_options::overwrite_existing);
+  std::filesystem::resize_file(torn_path, std::filesystem::file_size(torn_path) - 10);
+  msim::EventFileReader t(torn_path);
+  ASSERT_TRUE(t.ok());
+  EXPECT_EQ(drain(t).size(), 2u);
+  EXPECT_FALSE(t.ok());
+
+  EXPECT_FALSE(msim::EventFileReader(::testing::TempDir() + "msim_events_missing.bin").ok());
+}
+
+TEST(EventSources, MergeIsTimeOrderedAndDeterministic) {
+  const std::vector<msim::Event> a{msim::AddLimit{1, 10, msim::Side::Sell, 101, 1, 1},
+                                   msim::AddLimit{2, 30, msim::Side::Sell, 102, 1, 1}};
+  const std::vector<msim::Event> b{msim::AddLimit{3, 10, msim::Side::Buy, 99, 1, 2},
+                                   msim::AddMarket{4, 20, msim::Side::Buy, 1, 2}};
+
+  msim::MergedSource m;
+  m.add(std::make_unique<msim::SpanSource>(a));
+  m.add(std::make_unique<msim::SpanSource>(b));
+  EXPECT_TRUE(m.time_ordered());
+
+  std::vector<msim::OrderId> ids;
+  msim::Event e;
+  while (m.next(e)) ids.push_back(std::visit([](const auto& x) { return x.id; }, e));
+  EXPECT_EQ(ids, (std::vector<msim::OrderId>{1, 3, 4, 2})); // ts ties go to the first source
+
+  const std::vector<msim::Event> late_first{msim::Cancel{9, 50}, msim::Cancel{8, 5}};
+  msim::MergedSource mixed;
+  mixed.add(std::make_unique<msim::SpanSource>(a));
+  mixed.add(std::make_unique<msim::SpanSource>(late_first));
+  EXPECT_FALSE(mixed.time_ordered());
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "msim/exchange.hpp"
+#include "msim/order_flow.hpp"
+
+namespace {
+
+// Interleave an independent generated flow per instrument by timestamp
+std::vector<msim::Command> multi_flow(std::size_t instruments, double seconds) {
+  std::vector<msim::Command> cmds;
+  for (std::size_t k = 0; k < instruments; ++k) {
+    msim::OrderFlowGenerator gen(100 + k, msim::FlowParams{});
+    const auto inst = static_cast<msim::InstrumentId>(k);
+    for (const auto& e : gen.generate(0, seconds)) {
+      std::visit([&](const auto& x) {
+        using T = std::decay_t<decltype(x)>;
+        if constexpr (std::is_same_v<T, msim::AddLimit>) {
+          msim::Order o{x.id, x.ts, x.side, msim::OrderType::Limit, x.price, x.qty, x.owner};
+          o.instrument = inst;
+          cmds.push_back(msim::Command::submit(o));
+        } else if constexpr (std::is_same_v<T, msim::AddMarket>) {
+          msim::Order o{x.id, x.ts, x.side, msim::OrderType::Market, 0, x.qty, x.owner};
+          o.instrument = inst;
+          cmds.push_back(msim::Command::submit(o));
+        } else if constexpr (std::is_same_v<T, msim::Cancel>) {
+          cmds.push_back(msim::Command::cancel(x.id, x.ts, inst));
+        } else {
+          cmds.push_back(msim::Command::modify(x.id, x.new_qty, x.ts, inst));
+        }
+      }, e);
+    }
+  }
+  std::stable_sort(cmds.begin(), cmds.end(), [](const msim::Command& a, const msim::Command& b) {
+    return a.order.ts < b.order.ts;
+  });
+  return cmds;
+}
+
+std::vector<msim::Trade> run_with(std::size_t shards, std::size_t instruments,
+                                  const std::vector<msim::Command>& cmds) {
+  msim::Exchange ex(msim::ExchangeConfig{shards, 64}); // small queue exercises back-pressure
+  for (std::size_t k = 0; k < instruments; ++k) (void)ex.add_instrument();
+  ex.run(cmds);
+  auto out = ex.merged_trades();
+  ex.stop();
+  return out;
+}
+
+} // namespace
+
+TEST(Exchange, ShardCountDoesNotChangeTrades) {
+  const std::size_t n = 12;
+  const auto cmds = multi_flow(n, 5.0);
+
+  const auto inline_run = run_with(0, n, cmds);
+  ASSERT_FALSE(inline_run.empty());
+
+  for (std::size_t shards : {1u, 3u, 4u}) {
+    const auto sharded = run_with(shards, n, cmds);
+    ASSERT_EQ(sharded.size(), inline_run.size()) << "shards=" << shards;
+    for (std::size_t i = 0; i < sharded.size(); ++i) {
+      EXPECT_EQ(sharded[i].instrument, inline_run[i].instrument);
+      EXPECT_EQ(sharded[i].id, inline_run[i].id);
+      EXPECT_EQ(sharded[i].price, inline_run[i].price);
+      EXPECT_EQ(sharded[i].qty, inline_run[i].qty);
+      EXPECT_EQ(sharded[i].maker_order_id, inline_run[i].maker_order_id);
+    }
+  }
+}
+
+TEST(Exchange, InstrumentsKeepSeparateBooks) {
+  msim::Exchange ex(msim::ExchangeConfig{2, 16});
+  const auto a = ex.add_instrument();
+  const auto b = ex.add_instrument();
+  EXPECT_NE(ex.shard_of(a), ex.shard_of(b));
+
+  msim::Order ask{1, 10, msim::Side::Sell, msim::OrderType::Limit, 105, 5, 1};
+  ask.instrument = a;
+  msim::Order bid{1, 11, msim::Side::Buy, msim::OrderType::Limit, 106, 5, 2};
+  bid.instrument = b; // would cross `ask` if the books were shared
+
+  EXPECT_TRUE(ex.submit(msim::Command::submit(ask)));
+  EXPECT_TRUE(ex.submit(msim::Command::submit(bid)));
+  msim::Order stray = ask;
+  stray.instrument = 7;
+  EXPECT_FALSE(ex.submit(msim::Command::submit(stray)));
+  ex.drain();
+
+  EXPECT_TRUE(ex.trades(a).empty());
+  EXPECT_TRUE(ex.trades(b).empty());
+  EXPECT_EQ(*ex.engine(a).book().best_ask(), 105);
+  EXPECT_EQ(*ex.engine(b).book().best_bid(), 106);
+
+  msim::Order hit{2, 12, msim::Side::Buy, msim::OrderType::Market, 0, 2, 3};
+  hit.instrument = a;
+  EXPECT_TRUE(ex.submit(msim::Command::submit(hit)));
+  ex.drain();
+  ASSERT_EQ(ex.trades(a).size(), 1u);
+  EXPECT_EQ(ex.trades(a)[0].instrument, a);
+  EXPECT_EQ(ex.trades(a)[0].qty, 2);
+  EXPECT_EQ(ex.add_instrument(), msim::kInvalidInstrument); // running
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "msim/matching_engine.hpp"
+#include "msim/order_flow.hpp"
+
+namespace {
+
+msim::Order limit(msim::OrderId id, msim::Ts ts, msim::Side s, msim::Price px, msim::Qty q, msim::OwnerId owner) {
+  return msim::Order{id, ts, s, msim::OrderType::Limit, px, q, owner};
+}
+
+std::vector<msim::ExecReport> take_reports(msim::MatchingEngine& eng) {
+  std::vector<msim::ExecReport> out;
+  eng.exec_reports().drain([&](const msim::ExecReport& r) { out.push_back(r); });
+  return out;
+}
+
+} // namespace
+
+TEST(ExecReports, LifecycleOfContinuousOrders) {
+  msim::MatchingEngine eng;
+  eng.enable_exec_reports();
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(limit(1, 10, msim::Side::Sell, 105, 5, 1), trades);
+  auto r = take_reports(eng);
+  ASSERT_EQ(r.size(), 1u);
+  EXPECT_EQ(r[0].type, msim::ExecType::New);
+  EXPECT_EQ(r[0].leaves, 5);
+
+  (void)eng.process(limit(2, 11, msim::Side::Buy, 105, 3, 2), trades);
+  r = take_reports(eng);
+  ASSERT_EQ(r.size(), 2u);
+  EXPECT_EQ(r[0].type, msim::ExecType::PartialFill); // maker first
+  EXPECT_TRUE(r[0].maker);
+  EXPECT_EQ(r[0].owner, 1u);
+  EXPECT_EQ(r[0].side, msim::Side::Sell);
+  EXPECT_EQ(r[0].leaves, 2);
+  EXPECT_EQ(r[1].type, msim::ExecType::Fill);
+  EXPECT_EQ(r[1].owner, 2u);
+  EXPECT_EQ(r[1].side, msim::Side::Buy);
+  EXPECT_EQ(r[1].trade_id, trades.back().id);
+
+  msim::Order ioc = limit(3, 12, msim::Side::Buy, 105, 4, 3);
+  ioc.tif = msim::TimeInForce::IOC;
+  (void)eng.process(ioc, trades);
+  r = take_reports(eng);
+  ASSERT_EQ(r.size(), 3u);
+  EXPECT_EQ(r[0].type, msim::ExecType::Fill);        // maker done
+  EXPECT_EQ(r[1].type, msim::ExecType::PartialFill); // taker 2 of 4
+  EXPECT_EQ(r[2].type, msim::ExecType::Expire);
+  EXPECT_EQ(r[2].qty, 2);
+
+  (void)eng.process(limit(4, 13, msim::Side::Buy, 104, 0, 4), trades);
+  const std::vector<msim::Command> cmds{
+      msim::Command::submit(limit(5, 14, msim::Side::Buy, 103, 6, 5)),
+      msim::Command::modify(5, 4, 15),
+      msim::Command::modify(5, 9, 15), // reduce-only
+      msim::Command::cancel(5, 16),
+      msim::Command::cancel(42, 16),
+  };
+  (void)eng.process_batch(cmds, trades);
+  r = take_reports(eng);
+  ASSERT_EQ(r.size(), 6u);
+  EXPECT_EQ(r[0].type, msim::ExecType::Reject);
+  EXPECT_EQ(r[0].reason, msim::RejectReason::InvalidOrder);
+  EXPECT_EQ(r[1].type, msim::ExecType::New);
+  EXPECT_EQ(r[2].type, msim::ExecType::Cancel); // partial cancel via modify
+  EXPECT_EQ(r[2].qty, 2);
+  EXPECT_EQ(r[2].leaves, 4);
+  EXPECT_EQ(r[2].owner, 5u);
+  EXPECT_EQ(r[3].type, msim::ExecType::Reject);
+  EXPECT_EQ(r[4].type, msim::ExecType::Cancel);
+  EXPECT_EQ(r[4].qty, 4);
+  EXPECT_EQ(r[4].leaves, 0);
+  EXPECT_EQ(r[5].reason, msim::RejectReason::UnknownOrder);
+}
+
+TEST(ExecReports, AuctionQueueUncrossAndResidual) {
+  msim::MatchingEngine eng;
+  eng.enable_exec_reports();
+  eng.start_closing_auction(100);
+
+  std::vector<msim::Trade> trades;
+  (void)eng.process(limit(1, 10, msim::Side::Buy, 101, 4, 2), trades);
+  (void)eng.process(limit(2, 11, msim::Side::Sell, 100, 6, 1), trades);
+  auto r = take_reports(eng);
+  ASSERT_EQ(r.size(), 2u);
+  EXPECT_EQ(r[0].type, msim::ExecType::AuctionQueued);
+  EXPECT_EQ(r[1].type, msim::ExecType::AuctionQueued);
+
+  (void)eng.flush(100, trades);
+  ASSERT_EQ(trades.size(), 1u);
+  r = take_reports(eng);
+  ASSERT_EQ(r.size(), 3u);
+  EXPECT_EQ(r[0].order_id, 1u);
+  EXPECT_EQ(r[0].type, msim::ExecType::Fill);
+  EXPECT_EQ(r[1].order_id, 2u);
+  EXPECT_EQ(r[1].type, msim::ExecType::PartialFill);
+  EXPECT_EQ(r[1].leaves, 2);
+  EXPECT_EQ(r[1].owner, 1u);
+  EXPECT_EQ(r[2].type, msim::ExecType::New); // residual rests after the uncross
+  EXPECT_EQ(r[2].qty, 2);
+}
+
+TEST(ExecReports, ReconcileWithTradesOnGeneratedFlow) {
+  msim::OrderFlowGenerator gen(3, msim::FlowParams{});
+  const auto events = gen.generate(0, 20.0);
+
+  msim::MatchingEngine eng;
+  eng.enable_exec_reports();
+  std::vector<msim::Command> cmds;
+  for (const auto& e : events) {
+    std::visit([&](const auto& x) {
+      using T = std::decay_t<decltype(x)>;
+      if constexpr (std::is_same_v<T, msim::AddLimit>) {
+        cmds.push_back(msim::Command::submit(limit(x.id, x.ts, x.side, x.price, x.qty, x.owner)));
+      } else if constexpr (std::is_same_v<T, msim::AddMarket>) {
+        cmds.push_back(msim::Command::submit(msim::Order{x.id, x.ts, x.side, msim::OrderType::Market, 0, x.qty, x.owner}));
+      } else if constexpr (std::is_same_v<T, msim::Cancel>) {
+        cmds.push_back(msim::Command::cancel(x.id, x.ts));
+      } else {
+        cmds.push_back(msim::Command::modify(x.id, x.new_qty, x.ts));
+      }
+    }, e);
+  }
+  std::vector<msim::Trade> trades;
+  (void)eng.process_batch(cmds, trades);
+
+  int64_t maker_qty = 0, taker_qty = 0, traded = 0;
+  std::size_t fills = 0;
+  eng.exec_reports().drain([&](const msim::ExecReport& r) {
+    if (r.type != msim::ExecType::Fill && r.type != msim::ExecType::PartialFill) return;
+    ++fills;
+    (r.maker ? maker_qty : taker_qty) += r.qty;
+  });
+  for (const auto& t : trades) traded += t.qty;
+
+  EXPECT_EQ(fills, 2 * trades.size());
+  EXPECT_EQ(maker_qty, traded);
+  EXPECT_EQ(taker_qty, traded);
+  EXPECT_TRUE(eng.exec_reports().empty());
+}
+
+TEST(ExecReports, RingGrowsInsteadOfDropping) {
+  msim::ExecRing ring(16);
+  for (msim::OrderId i = 0; i < 10; ++i) ring.push(msim::ExecReport{i});
+  std::size_t seen = 0;
+  ring.drain([&](const msim::ExecReport&) { ++seen; });
+  for (msim::OrderId i = 0; i < 100; ++i) ring.push(msim::ExecReport{i}); // grows past 16
+  EXPECT_EQ(ring.size(), 100u);
+  EXPECT_GE(ring.capacity(), 100u);
+  for (std::size_t i = 0; i < ring.size(); ++i) EXPECT_EQ(ring[i].order_id, i);
+  EXPECT_EQ(seen, 10u);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "msim/matching_engine.hpp"
+#include "msim/timer_wheel.hpp"
+
+namespace {
+
+msim::Order gtd(msim::OrderId id, msim::Ts ts, msim::Side s, msim::Price px, msim::Qty q, msim::Ts expire) {
+  msim::Order o{id, ts, s, msim::OrderType::Limit, px, q, id};
+  o.tif = msim::TimeInForce::GTD;
+  o.expire_ts = expire;
+  return o;
+}
+
+} // namespace
+
+TEST(TimerWheel, FiresInDeadlineOrderAndNeverEarly) {
+  msim::TimerWheel w;
+  std::mt19937_64 rng(7);
+  std::vector<std::pair<msim::Ts, msim::OrderId>> ref;
+  for (msim::OrderId i = 1; i <= 5000; ++i) {
+    // Mix of near deadlines and ones many wheel levels out
+    const msim::Ts d = (i % 3 == 0) ? static_cast<msim::Ts>(rng() % 100'000)
+                                    : static_cast<msim::Ts>(rng() % (msim::Ts{1} << 50));
+    w.schedule(d, i);
+    ref.emplace_back(d, i);
+  }
+  std::sort(ref.begin(), ref.end());
+
+  std::vector<std::pair<msim::Ts, msim::OrderId>> fired;
+  msim::Ts t = 0;
+  for (int step = 0; step < 60 && !w.empty(); ++step) {
+    t = (step < 10) ? t + 10'000 : t * 2 + 1;
+    w.advance(t, [&](msim::OrderId id, msim::Ts d) {
+      EXPECT_LE(d, t);
+      fired.emplace_back(d, id);
+    });
+    // Everything due is gone, nothing else is
+    const auto due = static_cast<std::size_t>(
+        std::upper_bound(ref.begin(), ref.end(), std::make_pair(t, ~msim::OrderId{0})) - ref.begin());
+    EXPECT_EQ(fired.size(), due);
+  }
+  EXPECT_TRUE(w.empty());
+  ASSERT_EQ(fired.size(), ref.size());
+  for (std::size_t i = 1; i < fired.size(); ++i) EXPECT_LE(fired[i - 1].first, fired[i].first);
+
+  // Overdue timers fire on the next advance
+  w.schedule(1, 99);
+  int late = 0;
+  w.advance(t, [&](msim::OrderId id, msim::Ts) { late += (id == 99); });
+  EXPECT_EQ(late, 1);
+}
+
+TEST(GoodTillDate, RestsUntilDeadlineThenExpires) {
+  msim::MatchingEngine eng;
+  eng.enable_exec_reports();
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(gtd(1, 10, msim::Side::Buy, 100, 5, 1'000), trades);
+  (void)eng.process(gtd(2, 10, msim::Side::Buy, 99, 5, 2'000), trades);
+  (void)eng.process(msim::Order{3, 20, msim::Side::Sell, msim::OrderType::Limit, 100, 2, 3}, trades);
+  ASSERT_EQ(trades.size(), 1u);
+
+  (void)eng.flush(999, trades);
+  EXPECT_EQ(*eng.book().best_bid(), 100);
+
+  (void)eng.flush(1'000, trades); // live for ts < expire_ts
+  ASSERT_TRUE(eng.book().best_bid().has_value());
+  EXPECT_EQ(*eng.book().best_bid(), 99);
+
+  std::vector<msim::ExecReport> expired;
+  eng.exec_reports().drain([&](const msim::ExecReport& r) {
+    if (r.type == msim::ExecType::Expire) expired.push_back(r);
+  });
+  ASSERT_EQ(expired.size(), 1u);
+  EXPECT_EQ(expired[0].order_id, 1u);
+  EXPECT_EQ(expired[0].qty, 3); // leaves after the partial fill
+  EXPECT_EQ(expired[0].ts, 1'000);
+
+  // Cancelled early: its timer fires into nothing
+  const std::vector<msim::Command> cxl{msim::Command::cancel(2, 1'500)};
+  EXPECT_EQ(eng.process_batch(cxl, trades), 0u);
+  (void)eng.flush(5'000, trades);
+  EXPECT_TRUE(eng.book().empty(msim::Side::Buy));
+  std::size_t late = 0;
+  eng.exec_reports().drain([&](const msim::ExecReport& r) { late += (r.type == msim::ExecType::Expire); });
+  EXPECT_EQ(late, 0u);
+}
+
+TEST(GoodTillDate, LapsedOnArrivalIsRejectedAndStopsExpire) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+
+  const auto st = eng.process(gtd(1, 500, msim::Side::Buy, 100, 1, 500), trades);
+  EXPECT_EQ(st.status, msim::OrderStatus::Rejected);
+  EXPECT_EQ(st.reject_reason, msim::RejectReason::InvalidOrder);
+
+  msim::Order no_deadline = gtd(2, 500, msim::Side::Buy, 100, 1, 0);
+  EXPECT_EQ(eng.process(no_deadline, trades).status, msim::OrderStatus::Rejected);
+
+  msim::Order stop = gtd(3, 500, msim::Side::Buy, 0, 1, 900);
+  stop.type = msim::OrderType::Market;
+  stop.stop_price = 120;
+  (void)eng.process(stop, trades);
+  EXPECT_EQ(eng.stops().size(), 1u);
+  (void)eng.flush(900, trades);
+  EXPECT_TRUE(eng.stops().empty());
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "msim/command.hpp"
+#include "msim/matching_engine.hpp"
+
+namespace {
+
+msim::Order limit(msim::OrderId id, msim::Ts ts, msim::Side s, msim::Price px, msim::Qty q, msim::OwnerId owner) {
+  return msim::Order{id, ts, s, msim::OrderType::Limit, px, q, owner};
+}
+
+msim::Order iceberg(msim::OrderId id, msim::Ts ts, msim::Side s, msim::Price px, msim::Qty q, msim::Qty peak,
+                    msim::OwnerId owner) {
+  msim::Order o = limit(id, ts, s, px, q, owner);
+  o.display_qty = peak;
+  return o;
+}
+
+} // namespace
+
+TEST(Iceberg, ReplenishesAtLevelTailAndShowsOnlyPeak) {
+  msim::MatchingEngine eng;
+  eng.enable_exec_reports();
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(iceberg(1, 1, msim::Side::Sell, 100, 10, 3, 1), trades);
+  (void)eng.process(limit(2, 2, msim::Side::Sell, 100, 2, 2), trades);
+  auto d = eng.book().depth(msim::Side::Sell, 1);
+  ASSERT_EQ(d.size(), 1u);
+  EXPECT_EQ(d[0].total_qty, 5); // 3 shown + 2, reserve hidden
+  EXPECT_EQ(d[0].order_count, 2u);
+
+  // First slice trades out and the refill queues behind order 2
+  (void)eng.process(limit(3, 3, msim::Side::Buy, 100, 4, 3), trades);
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[0].maker_order_id, 1u);
+  EXPECT_EQ(trades[0].qty, 3);
+  EXPECT_EQ(trades[1].maker_order_id, 2u);
+  EXPECT_EQ(trades[1].qty, 1);
+  EXPECT_EQ(eng.book().depth(msim::Side::Sell, 1)[0].total_qty, 4);
+
+  // Sweeps through a second refill within one taker
+  (void)eng.process(limit(4, 4, msim::Side::Buy, 100, 5, 3), trades);
+  ASSERT_EQ(trades.size(), 5u);
+  EXPECT_EQ(trades[2].maker_order_id, 2u);
+  EXPECT_EQ(trades[3].maker_order_id, 1u);
+  EXPECT_EQ(trades[3].qty, 3);
+  EXPECT_EQ(trades[4].maker_order_id, 1u);
+  EXPECT_EQ(trades[4].qty, 1);
+  d = eng.book().depth(msim::Side::Sell, 1);
+  EXPECT_EQ(d[0].total_qty, 2);
+  EXPECT_EQ(d[0].order_count, 1u);
+
+  msim::ExecReport last{};
+  eng.exec_reports().drain([&](const msim::ExecReport& r) {
+    if (r.order_id == 1 && r.maker) last = r;
+  });
+  EXPECT_EQ(last.type, msim::ExecType::PartialFill);
+  EXPECT_EQ(last.leaves, 3); // 2 shown + 1 hidden
+
+  // The refilled node keeps its locator
+  const std::vector<msim::Command> cxl{msim::Command::cancel(1, 5)};
+  EXPECT_EQ(eng.process_batch(cxl, trades), 0u);
+  EXPECT_TRUE(eng.book().empty(msim::Side::Sell));
+}
+
+TEST(Iceberg, ModifyTrimsReserveBeforeShownQty) {
+  msim::OrderBook ob;
+  ASSERT_TRUE(ob.add_resting_limit(iceberg(1, 1, msim::Side::Buy, 100, 10, 4, 1)));
+  EXPECT_EQ(ob.depth(msim::Side::Buy, 1)[0].total_qty, 4);
+
+  EXPECT_TRUE(ob.modify_qty(1, 6));  // 4 shown + 2 hidden
+  EXPECT_EQ(ob.depth(msim::Side::Buy, 1)[0].total_qty, 4);
+  EXPECT_TRUE(ob.modify_qty(1, 3));  // reserve gone, shown cut
+  EXPECT_EQ(ob.depth(msim::Side::Buy, 1)[0].total_qty, 3);
+  EXPECT_FALSE(ob.modify_qty(1, 5)); // still reduce-only
+}
+
+TEST(Iceberg, FillOrKillSeesHiddenReserve) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+  (void)eng.process(iceberg(1, 1, msim::Side::Sell, 100, 10, 2, 1), trades);
+
+  msim::Order fok = limit(2, 2, msim::Side::Buy, 100, 8, 2);
+  fok.tif = msim::TimeInForce::FOK;
+  const auto st = eng.process(fok, trades);
+  EXPECT_EQ(st.filled_qty, 8);
+  ASSERT_EQ(trades.size(), 4u);
+  for (const auto& t : trades) EXPECT_EQ(t.qty, 2);
+  EXPECT_EQ(eng.book().depth(msim::Side::Sell, 1)[0].total_qty, 2);
+}
+
+TEST(Iceberg, SelfTradeCancelReportsHiddenReserve) {
+  msim::RulesConfig cfg{};
+  cfg.stp = msim::StpMode::CancelMaker;
+  msim::MatchingEngine eng{msim::RuleSet{cfg}};
+  eng.enable_exec_reports();
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(iceberg(1, 1, msim::Side::Sell, 100, 10, 3, 7), trades);
+  eng.exec_reports().drain([](const msim::ExecReport&) {});
+
+  (void)eng.process(limit(2, 2, msim::Side::Buy, 100, 1, 7), trades);
+  EXPECT_TRUE(trades.empty());
+
+  bool seen = false;
+  eng.exec_reports().drain([&](const msim::ExecReport& r) {
+    if (r.order_id != 1) return;
+    EXPECT_EQ(r.type, msim::ExecType::Cancel);
+    EXPECT_EQ(r.reason, msim::RejectReason::SelfTradePrevented);
+    EXPECT_EQ(r.qty, 10); // shown peak plus hidden reserve
+    seen = true;
+  });
+  EXPECT_TRUE(seen);
+}
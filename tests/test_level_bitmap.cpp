@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <set>
+
+#include "msim/level_bitmap.hpp"
+#include "msim/rng.hpp"
+
+TEST(LevelBitmap, NextAndPrevAcrossWideGaps) {
+  msim::LevelBitmap bm(100'000); // three layers
+
+  bm.set(3);
+  bm.set(70'000);
+  bm.set(99'999);
+
+  EXPECT_EQ(bm.find_next(0), 3u);
+  EXPECT_EQ(bm.find_next(4), 70'000u);
+  EXPECT_EQ(bm.find_next(70'001), 99'999u);
+  EXPECT_EQ(bm.find_prev(69'999), 3u);
+  EXPECT_EQ(bm.find_prev(99'998), 70'000u);
+  EXPECT_EQ(bm.find_prev(2), msim::LevelBitmap::npos);
+
+  bm.reset(70'000);
+  EXPECT_EQ(bm.find_next(4), 99'999u);
+  EXPECT_EQ(bm.find_prev(99'998), 3u);
+
+  bm.reset(3);
+  bm.reset(99'999);
+  EXPECT_FALSE(bm.any());
+  EXPECT_EQ(bm.find_next(0), msim::LevelBitmap::npos);
+}
+
+TEST(LevelBitmap, MatchesOrderedSet) {
+  const std::size_t n = 5000;
+  msim::LevelBitmap bm(n);
+  std::set<std::size_t> ref;
+  msim::Rng rng(3);
+
+  for (int step = 0; step < 20'000; ++step) {
+    const auto i = static_cast<std::size_t>(rng.uniform_int(0, static_cast<int32_t>(n - 1)));
+    if (rng.uniform01() < 0.5) { bm.set(i); ref.insert(i); }
+    else { bm.reset(i); ref.erase(i); }
+
+    const auto q = static_cast<std::size_t>(rng.uniform_int(0, static_cast<int32_t>(n - 1)));
+    auto lo = ref.lower_bound(q);
+    EXPECT_EQ(bm.find_next(q), lo == ref.end() ? msim::LevelBitmap::npos : *lo);
+
+    auto hi = ref.upper_bound(q);
+    EXPECT_EQ(bm.find_prev(q), hi == ref.begin() ? msim::LevelBitmap::npos : *std::prev(hi));
+  }
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <vector>
+
 #include "msim/matching_engine.hpp"
 
 TEST(MatchingEngine, FIFOAtSamePrice) {
@@ -40,3 +42,45 @@ TEST(MatchingEngine, LimitBuyPartialFillThenRest) {
   EXPECT_EQ(*eng.book().best_ask(), 106);
   EXPECT_FALSE(eng.book().is_crossed());
 }
+
+TEST(MatchingEngine, BufferPathAppendsAndReusesCapacity) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> fills;
+  fills.reserve(4);
+  const auto* storage = fills.data();
+
+  for (msim::OrderId i = 1; i <= 100; ++i) {
+    fills.clear();
+    const auto ts = static_cast<msim::Ts>(2 * i);
+    (void)eng.process(msim::Order{i, ts, msim::Side::Sell, msim::OrderType::Limit, 105, 3, 1}, fills);
+    (void)eng.process(msim::Order{i + 1000, ts, msim::Side::Sell, msim::OrderType::Limit, 106, 2, 1}, fills);
+    const auto st = eng.process(msim::Order{i + 2000, ts + 1, msim::Side::Buy, msim::OrderType::Limit, 106, 5, 2}, fills);
+
+    // Sweeps both asks: 3 @105 then 2 @106, nothing left to rest
+    ASSERT_EQ(fills.size(), 2u);
+    EXPECT_EQ(fills[0].price, 105);
+    EXPECT_EQ(fills[1].price, 106);
+    EXPECT_EQ(st.filled_qty, 5);
+    EXPECT_FALSE(st.resting.has_value());
+  }
+  EXPECT_EQ(fills.data(), storage); // steady state never reallocated the buffer
+}
+
+TEST(MatchingEngine, SellLimitSweepsBidsDownToItsPrice) {
+  msim::MatchingEngine eng;
+
+  EXPECT_TRUE(eng.book_mut().add_resting_limit(msim::Order{1, 10, msim::Side::Buy, msim::OrderType::Limit, 105, 2, 1}));
+  EXPECT_TRUE(eng.book_mut().add_resting_limit(msim::Order{2, 11, msim::Side::Buy, msim::OrderType::Limit, 104, 2, 1}));
+  EXPECT_TRUE(eng.book_mut().add_resting_limit(msim::Order{3, 12, msim::Side::Buy, msim::OrderType::Limit, 103, 2, 1}));
+
+  // Sell 5 @104: takes 105 and 104, stops before 103, rests 1 @104
+  auto res = eng.process(msim::Order{100, 20, msim::Side::Sell, msim::OrderType::Limit, 104, 5, 9});
+
+  ASSERT_EQ(res.trades.size(), 2u);
+  EXPECT_EQ(res.trades[0].price, 105);
+  EXPECT_EQ(res.trades[1].price, 104);
+  ASSERT_TRUE(res.resting.has_value());
+  EXPECT_EQ(res.resting->qty, 1);
+  EXPECT_EQ(*eng.book().best_bid(), 103);
+  EXPECT_EQ(*eng.book().best_ask(), 104);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <unordered_map>
+
+#include "msim/order_index.hpp"
+#include "msim/rng.hpp"
+
+namespace {
+msim::OrderId make_id(uint64_t owner, uint32_t seq) {
+  return (owner << 32) | seq;
+}
+} // namespace
+
+TEST(FlatOrderMap, InsertFindErase) {
+  msim::FlatOrderMap<int> m;
+
+  EXPECT_TRUE(m.insert_or_assign(make_id(2, 1), 10));
+  EXPECT_TRUE(m.insert_or_assign(make_id(2, 2), 20));
+  EXPECT_FALSE(m.insert_or_assign(make_id(2, 1), 11)); // overwrite
+
+  const auto* first = m.find(make_id(2, 1));
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(*first, 11);
+  EXPECT_EQ(m.size(), 2u);
+
+  EXPECT_TRUE(m.erase(make_id(2, 1)));
+  EXPECT_FALSE(m.erase(make_id(2, 1)));
+  EXPECT_EQ(m.find(make_id(2, 1)), nullptr);
+  const auto* second = m.find(make_id(2, 2));
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(*second, 20);
+}
+
+TEST(FlatOrderMap, MatchesUnorderedMapUnderChurn) {
+  msim::FlatOrderMap<uint64_t> flat(64); // small dense range mixed with owner ids
+  std::unordered_map<msim::OrderId, uint64_t> ref;
+  msim::Rng rng(7);
+
+  for (int i = 0; i < 50'000; ++i) {
+    const auto owner = static_cast<uint64_t>(rng.uniform_int(0, 3));
+    const auto seq = static_cast<uint32_t>(rng.uniform_int(0, 2000));
+    const msim::OrderId id = make_id(owner, seq);
+
+    if (rng.uniform01() < 0.55) {
+      const auto v = static_cast<uint64_t>(i);
+      EXPECT_EQ(flat.insert_or_assign(id, v), ref.find(id) == ref.end());
+      ref[id] = v;
+    } else {
+      EXPECT_EQ(flat.erase(id), ref.erase(id) == 1u);
+    }
+  }
+
+  EXPECT_EQ(flat.size(), ref.size());
+  for (const auto& [id, v] : ref) {
+    const auto* p = flat.find(id);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(*p, v);
+  }
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "msim/order_pool.hpp"
+
+TEST(SlabPool, IntrusiveFifoKeepsArrivalOrder) {
+  msim::SlabPool<int, 2> pool; // 4-node slabs to exercise growth
+  msim::IntrusiveFifo q;
+
+  std::vector<msim::NodeHandle> hs;
+  for (int i = 0; i < 10; ++i) {
+    hs.push_back(pool.alloc(i));
+    pool.push_back(q, hs.back());
+  }
+  EXPECT_EQ(q.size(), 10u);
+
+  // Remove from front, middle and back
+  pool.unlink(q, hs[0]); pool.release(hs[0]);
+  pool.unlink(q, hs[5]); pool.release(hs[5]);
+  pool.unlink(q, hs[9]); pool.release(hs[9]);
+
+  std::vector<int> seen;
+  pool.for_each(q, [&](msim::NodeHandle, int& v) { seen.push_back(v); return true; });
+  EXPECT_EQ(seen, (std::vector<int>{1, 2, 3, 4, 6, 7, 8}));
+  EXPECT_EQ(pool[q.front()], 1);
+}
+
+TEST(SlabPool, SteadyStateChurnDoesNotGrow) {
+  msim::SlabPool<int, 4> pool;
+  msim::IntrusiveFifo q;
+
+  for (int i = 0; i < 16; ++i) pool.push_back(q, pool.alloc(i));
+  const auto cap = pool.capacity();
+  const int* slab0 = &pool[0];
+
+  // add/remove cycles at constant depth must recycle nodes
+  for (int i = 0; i < 10'000; ++i) {
+    const auto h = q.front();
+    pool.unlink(q, h);
+    pool.release(h);
+    pool.push_back(q, pool.alloc(i));
+  }
+
+  EXPECT_EQ(pool.capacity(), cap);
+  EXPECT_EQ(pool.live(), 16u);
+  EXPECT_EQ(&pool[0], slab0); // slab storage never moved
+}
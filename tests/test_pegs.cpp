@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "msim/command.hpp"
+#include "msim/matching_engine.hpp"
+#include "msim/peg_book.hpp"
+
+namespace {
+
+msim::Order limit(msim::OrderId id, msim::Ts ts, msim::Side s, msim::Price px, msim::Qty q) {
+  return msim::Order{id, ts, s, msim::OrderType::Limit, px, q, id};
+}
+
+msim::Order pegged(msim::OrderId id, msim::Ts ts, msim::Side s, msim::PegType peg, msim::Price offset, msim::Qty q) {
+  msim::Order o = limit(id, ts, s, 0, q);
+  o.peg = peg;
+  o.peg_offset = offset;
+  return o;
+}
+
+} // namespace
+
+TEST(PegBook, ResolvesAgainstLitBboAndStaysPassive) {
+  using msim::PegBook;
+  using msim::PegType;
+  using msim::Side;
+
+  EXPECT_EQ(PegBook::price_of(Side::Buy, PegType::Primary, 0, 100, 105, 1), 100);
+  EXPECT_EQ(PegBook::price_of(Side::Buy, PegType::Primary, 10, 100, 105, 1), 104); // capped under the ask
+  EXPECT_EQ(PegBook::price_of(Side::Sell, PegType::Market, 0, 100, 105, 1), 101); // floored over the bid
+  EXPECT_EQ(PegBook::price_of(Side::Buy, PegType::Mid, 0, 100, 105, 1), 102);
+  EXPECT_EQ(PegBook::price_of(Side::Sell, PegType::Mid, 0, 100, 105, 1), 103);
+  EXPECT_EQ(PegBook::price_of(Side::Buy, PegType::Mid, 0, 100, 110, 5), 105);
+  EXPECT_FALSE(PegBook::price_of(Side::Buy, PegType::Primary, 0, std::nullopt, 105, 1).has_value());
+  EXPECT_FALSE(PegBook::price_of(Side::Sell, PegType::Mid, 0, 100, std::nullopt, 1).has_value());
+}
+
+TEST(Pegs, MidPegImprovesAndReprices) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(limit(1, 1, msim::Side::Buy, 100, 5), trades);
+  (void)eng.process(limit(2, 1, msim::Side::Sell, 106, 5), trades);
+  (void)eng.process(pegged(3, 2, msim::Side::Buy, msim::PegType::Mid, 0, 4), trades);
+
+  // Non-displayed: the lit book does not see it
+  EXPECT_EQ(*eng.book().best_bid(), 100);
+  EXPECT_EQ(eng.book().depth(msim::Side::Buy, 4).size(), 1u);
+  EXPECT_EQ(eng.pegs().size(), 1u);
+
+  (void)eng.process(limit(4, 3, msim::Side::Sell, 101, 3), trades);
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].maker_order_id, 3u);
+  EXPECT_EQ(trades[0].price, 103); // mid of 100/106
+
+  // Bid moves up: the peg follows without being touched
+  (void)eng.process(limit(5, 4, msim::Side::Buy, 104, 1), trades);
+  (void)eng.process(msim::Order{6, 5, msim::Side::Sell, msim::OrderType::Market, 0, 3, 6}, trades);
+  ASSERT_EQ(trades.size(), 4u);
+  EXPECT_EQ(trades[1].maker_order_id, 3u);
+  EXPECT_EQ(trades[1].price, 105);
+  EXPECT_EQ(trades[2].price, 104);
+  EXPECT_EQ(trades[3].price, 100);
+  EXPECT_TRUE(eng.pegs().empty());
+}
+
+TEST(Pegs, CrossingPegsTradeAtMakerPrice) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(limit(1, 1, msim::Side::Buy, 100, 1), trades);
+  (void)eng.process(limit(2, 1, msim::Side::Sell, 110, 1), trades);
+  (void)eng.process(pegged(3, 2, msim::Side::Buy, msim::PegType::Mid, 0, 5), trades);
+  (void)eng.process(pegged(4, 3, msim::Side::Sell, msim::PegType::Market, 2, 3), trades);
+
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].maker_order_id, 3u);
+  EXPECT_EQ(trades[0].taker_order_id, 4u);
+  EXPECT_EQ(trades[0].price, 105);
+  EXPECT_EQ(trades[0].qty, 3);
+  ASSERT_NE(eng.pegs().find(3), nullptr);
+  EXPECT_EQ(eng.pegs().find(3)->qty, 2);
+  EXPECT_FALSE(eng.pegs().contains(4));
+}
+
+TEST(Pegs, LitKeepsPriorityAndUnpricedPegsWait) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(limit(1, 1, msim::Side::Buy, 100, 2), trades);
+  (void)eng.process(pegged(2, 2, msim::Side::Buy, msim::PegType::Primary, 0, 5), trades);
+
+  // Same price as the lit bid: lit first, then the peg at the price it had on arrival
+  (void)eng.process(limit(3, 3, msim::Side::Sell, 100, 3), trades);
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[0].maker_order_id, 1u);
+  EXPECT_EQ(trades[1].maker_order_id, 2u);
+  EXPECT_EQ(trades[1].price, 100);
+  EXPECT_EQ(trades[1].qty, 1);
+  EXPECT_FALSE(eng.book().best_bid().has_value());
+
+  // The lit bid is gone, so the peg has lost its reference and waits
+  (void)eng.process(limit(7, 3, msim::Side::Sell, 100, 1), trades);
+  EXPECT_EQ(trades.size(), 2u);
+  EXPECT_EQ(*eng.book().best_ask(), 100);
+  EXPECT_EQ(eng.pegs().size(), 1u);
+
+  const std::vector<msim::Command> cmds{msim::Command::modify(2, 4, 4), msim::Command::cancel(2, 5)};
+  std::vector<msim::OrderStatus> st;
+  eng.process_batch(cmds, trades, [&](const msim::Command&, const msim::ProcessStatus& s, auto) {
+    st.push_back(s.status);
+  });
+  EXPECT_EQ(st, (std::vector<msim::OrderStatus>{msim::OrderStatus::Accepted, msim::OrderStatus::Accepted}));
+  EXPECT_TRUE(eng.pegs().empty());
+
+  msim::Order bad = pegged(9, 6, msim::Side::Buy, msim::PegType::Mid, 0, 1);
+  bad.tif = msim::TimeInForce::IOC;
+  EXPECT_EQ(eng.process(bad, trades).status, msim::OrderStatus::Rejected);
+}
+
+TEST(Pegs, PrimaryPegAtTheTouchFillsDuringSweep) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(limit(1, 1, msim::Side::Buy, 100, 2), trades);
+  (void)eng.process(limit(2, 1, msim::Side::Buy, 99, 5), trades);
+  (void)eng.process(pegged(3, 2, msim::Side::Buy, msim::PegType::Primary, 0, 5), trades);
+
+  // The peg is priced at 100 when the sweep starts and keeps that price once the lit level is gone
+  (void)eng.process(msim::Order{4, 3, msim::Side::Sell, msim::OrderType::Market, 0, 20, 4}, trades);
+  ASSERT_EQ(trades.size(), 3u);
+  EXPECT_EQ(trades[0].maker_order_id, 1u);
+  EXPECT_EQ(trades[0].price, 100);
+  EXPECT_EQ(trades[1].maker_order_id, 3u);
+  EXPECT_EQ(trades[1].price, 100);
+  EXPECT_EQ(trades[1].qty, 5);
+  EXPECT_EQ(trades[2].maker_order_id, 2u);
+  EXPECT_EQ(trades[2].price, 99);
+  EXPECT_TRUE(eng.pegs().empty());
+  EXPECT_FALSE(eng.book().best_bid().has_value());
+}
+
+TEST(Pegs, CancelThatWidensSpreadCrossesPegs) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(limit(1, 1, msim::Side::Buy, 100, 5), trades);
+  (void)eng.process(limit(2, 1, msim::Side::Sell, 101, 5), trades);
+  (void)eng.process(limit(3, 1, msim::Side::Sell, 110, 5), trades);
+
+  // Held apart by the one-tick spread: buy capped at 100, sell floored at 101
+  (void)eng.process(pegged(4, 2, msim::Side::Buy, msim::PegType::Primary, 3, 2), trades);
+  (void)eng.process(pegged(5, 3, msim::Side::Sell, msim::PegType::Market, 2, 2), trades);
+  EXPECT_TRUE(trades.empty());
+  EXPECT_EQ(eng.pegs().size(), 2u);
+
+  // Pulling the 101 offer frees the buy peg up to 103, through the sell peg at 102
+  const std::vector<msim::Command> cmds{msim::Command::cancel(2, 4)};
+  eng.process_batch(cmds, trades);
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].qty, 2);
+  EXPECT_TRUE(eng.pegs().empty());
+  EXPECT_EQ(*eng.book().best_ask(), 110);
+}
+
+TEST(Pegs, RestWhenTheLitBookIsOutsideTheBand) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+
+  // Last 100; the lit bid and ask both sit outside the 12.5% band
+  (void)eng.process(limit(1, 1, msim::Side::Buy, 100, 1), trades);
+  (void)eng.process(limit(2, 1, msim::Side::Sell, 100, 1), trades);
+  (void)eng.process(limit(3, 2, msim::Side::Buy, 80, 5), trades);
+  (void)eng.process(limit(4, 2, msim::Side::Sell, 120, 5), trades);
+  ASSERT_EQ(trades.size(), 1u);
+  ASSERT_EQ(eng.rules().phase(), msim::MarketPhase::Continuous);
+
+  // A peg is not an aggressor: neither side may start a volatility auction
+  EXPECT_EQ(eng.process(pegged(5, 3, msim::Side::Sell, msim::PegType::Primary, 0, 2), trades).status,
+            msim::OrderStatus::Accepted);
+  EXPECT_EQ(eng.process(pegged(6, 3, msim::Side::Buy, msim::PegType::Primary, 0, 2), trades).status,
+            msim::OrderStatus::Accepted);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::Continuous);
+  EXPECT_EQ(eng.pegs().size(), 2u);
+  EXPECT_TRUE(eng.pegs().contains(5));
+  EXPECT_TRUE(eng.pegs().contains(6));
+  EXPECT_EQ(trades.size(), 1u);
+}
+
+TEST(Pegs, CrossOnCancelTripsBreakerAndElectsStops) {
+  // Held apart by the 70/71 spread; pulling the 71 offer crosses them at 73,
+  // more than 25% under the first print at 100
+  auto setup = [](msim::MatchingEngine& eng, std::vector<msim::Trade>& trades) {
+    (void)eng.process(limit(1, 1, msim::Side::Buy, 100, 1), trades);
+    (void)eng.process(limit(2, 1, msim::Side::Sell, 100, 1), trades);
+    (void)eng.process(limit(3, 2, msim::Side::Buy, 70, 5), trades);
+    (void)eng.process(limit(4, 2, msim::Side::Sell, 71, 5), trades);
+    (void)eng.process(limit(5, 2, msim::Side::Sell, 80, 5), trades);
+    (void)eng.process(pegged(6, 3, msim::Side::Buy, msim::PegType::Primary, 3, 2), trades);
+    (void)eng.process(pegged(7, 3, msim::Side::Sell, msim::PegType::Market, 2, 2), trades);
+  };
+  const std::vector<msim::Command> cancel{msim::Command::cancel(4, 5)};
+
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+  setup(eng, trades);
+  ASSERT_EQ(trades.size(), 1u);
+  eng.process_batch(cancel, trades);
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[1].price, 73);
+  EXPECT_EQ(eng.rules().phase(), msim::MarketPhase::Halted);
+
+  // Without the breaker the same print elects a resting sell stop at once
+  msim::RulesConfig cfg{};
+  cfg.enable_circuit_breaker = false;
+  msim::MatchingEngine eng2{msim::RuleSet{cfg}};
+  std::vector<msim::Trade> trades2;
+  setup(eng2, trades2);
+  msim::Order stop{8, 4, msim::Side::Sell, msim::OrderType::Market, 0, 1, 8};
+  stop.stop_price = 73;
+  (void)eng2.process(stop, trades2);
+  ASSERT_EQ(trades2.size(), 1u);
+  eng2.process_batch(cancel, trades2);
+  ASSERT_EQ(trades2.size(), 3u);
+  EXPECT_EQ(trades2[1].price, 73);
+  EXPECT_EQ(trades2[2].taker_order_id, 8u);
+  EXPECT_EQ(trades2[2].price, 70);
+}
+
+TEST(Pegs, OffsetsCollapsedOntoTheCapKeepTimePriority) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(limit(1, 1, msim::Side::Buy, 100, 5), trades);
+  (void)eng.process(limit(2, 1, msim::Side::Sell, 103, 5), trades);
+
+  // Both capped one tick under the ask at 102; the older, smaller offset goes first
+  (void)eng.process(pegged(3, 2, msim::Side::Buy, msim::PegType::Primary, 2, 1), trades);
+  (void)eng.process(pegged(4, 3, msim::Side::Buy, msim::PegType::Primary, 5, 1), trades);
+
+  (void)eng.process(limit(5, 4, msim::Side::Sell, 102, 1), trades);
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].maker_order_id, 3u);
+  EXPECT_EQ(trades[0].price, 102);
+  EXPECT_FALSE(eng.pegs().contains(3));
+  EXPECT_TRUE(eng.pegs().contains(4));
+
+  (void)eng.process(limit(6, 5, msim::Side::Sell, 102, 1), trades);
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[1].maker_order_id, 4u);
+  EXPECT_TRUE(eng.pegs().empty());
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "msim/book.hpp"
+#include "msim/price_ladder.hpp"
+
+namespace {
+struct L {
+  int qty{0};
+};
+} // namespace
+
+TEST(PriceLadder, WindowAndOverflowKeepPriceOrder) {
+  msim::PriceLadder<L, msim::Side::Sell> asks(1, 8);
+
+  asks.get_or_create(100).qty = 1;  // anchors window [96, 104)
+  asks.get_or_create(103).qty = 2;
+  asks.get_or_create(250).qty = 3;  // overflow (worse than best)
+  asks.get_or_create(101).qty = 4;
+
+  ASSERT_TRUE(asks.best_price().has_value());
+  EXPECT_EQ(*asks.best_price(), 100);
+  EXPECT_EQ(asks.size(), 4u);
+
+  std::vector<msim::Price> seen;
+  asks.for_each([&](msim::Price px, const L&) { seen.push_back(px); return true; });
+  EXPECT_EQ(seen, (std::vector<msim::Price>{100, 101, 103, 250}));
+
+  asks.erase(100);
+  EXPECT_EQ(*asks.best_price(), 101);
+}
+
+TEST(PriceLadder, RecentersWhenMarketDriftsPastWindow) {
+  msim::PriceLadder<L, msim::Side::Buy> bids(1, 8);
+
+  bids.get_or_create(100).qty = 1;
+  bids.get_or_create(500).qty = 2;  // better than best, outside window -> recenter
+
+  ASSERT_NE(bids.find(500), nullptr);
+  EXPECT_EQ(bids.find(500)->qty, 2);
+  EXPECT_EQ(bids.find(100)->qty, 1); // now held in overflow
+  EXPECT_EQ(*bids.best_price(), 500);
+
+  // Draining the window pulls the overflow best back in
+  bids.erase(500);
+  EXPECT_EQ(*bids.best_price(), 100);
+  EXPECT_EQ(bids.find(100)->qty, 1);
+}
+
+TEST(PriceLadder, OffGridPricesSpillToOverflow) {
+  msim::PriceLadder<L, msim::Side::Sell> asks(5, 16);
+
+  asks.get_or_create(100).qty = 1;
+  asks.get_or_create(103).qty = 2; // not a multiple of tick
+  asks.get_or_create(105).qty = 3;
+
+  std::vector<msim::Price> seen;
+  asks.for_each([&](msim::Price px, const L&) { seen.push_back(px); return true; });
+  EXPECT_EQ(seen, (std::vector<msim::Price>{100, 103, 105}));
+}
+
+TEST(PriceLadder, MapBackedBookMatchesLadderBook) {
+  msim::OrderBook ladder{msim::BookConfig{1, 64}};
+  msim::OrderBook mapped{msim::BookConfig{1, 0}};
+
+  for (msim::OrderBook* ob : {&ladder, &mapped}) {
+    for (msim::OrderId i = 1; i <= 40; ++i) {
+      const auto k = static_cast<msim::Price>(i);
+      EXPECT_TRUE(ob->add_resting_limit(msim::Order{i, 1, msim::Side::Buy, msim::OrderType::Limit, 1000 - 7 * k, 1, 1}));
+      EXPECT_TRUE(ob->add_resting_limit(msim::Order{100 + i, 1, msim::Side::Sell, msim::OrderType::Limit, 1001 + 7 * k, 1, 1}));
+    }
+    EXPECT_TRUE(ob->cancel(1));
+    EXPECT_TRUE(ob->cancel(101));
+  }
+
+  EXPECT_EQ(ladder.best_bid(), mapped.best_bid());
+  EXPECT_EQ(ladder.best_ask(), mapped.best_ask());
+
+  const auto lb = ladder.depth(msim::Side::Buy, 50);
+  const auto mb = mapped.depth(msim::Side::Buy, 50);
+  ASSERT_EQ(lb.size(), mb.size());
+  for (std::size_t i = 0; i < lb.size(); ++i) EXPECT_EQ(lb[i].price, mb[i].price);
+}
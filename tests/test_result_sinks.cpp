@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "msim/order_flow.hpp"
+#include "msim/result_sink.hpp"
+#include "msim/simulator.hpp"
+#include "msim/world.hpp"
+
+#include "msim/agents/market_maker.hpp"
+#include "msim/agents/noise_trader.hpp"
+
+namespace {
+
+msim::World make_world() {
+  msim::RulesConfig cfg{};
+  msim::World w{msim::MatchingEngine{msim::RuleSet(cfg)}};
+  w.add_agent(std::make_unique<msim::agents::NoiseTrader>(msim::OwnerId{1}, msim::agents::NoiseTraderConfig{}));
+  w.add_agent(std::make_unique<msim::MarketMaker>(msim::OwnerId{2}, cfg, msim::MarketMakerParams{}));
+  return w;
+}
+
+std::size_t count_lines(const std::string& path) {
+  std::ifstream f(path);
+  std::size_t n = 0;
+  for (std::string line; std::getline(f, line);) ++n;
+  return n;
+}
+
+} // namespace
+
+TEST(ResultSinks, CountingSinkMatchesMaterializedWorldRun) {
+  auto w1 = make_world();
+  const auto full = w1.run(5, 2.0);
+
+  auto w2 = make_world();
+  msim::CountingSink counts;
+  w2.run(5, 2.0, counts);
+
+  int64_t qty = 0;
+  for (const auto& t : full.trades) qty += t.qty;
+  EXPECT_EQ(counts.trades, full.trades.size());
+  EXPECT_EQ(counts.traded_qty, qty);
+  EXPECT_EQ(counts.tops, full.tops.size());
+  EXPECT_EQ(counts.accounts, full.accounts.size());
+  EXPECT_EQ(counts.cancel_failures, static_cast<uint64_t>(full.cancel_failures));
+  EXPECT_EQ(counts.modify_failures, static_cast<uint64_t>(full.modify_failures));
+}
+
+TEST(ResultSinks, NullSinkLeavesEngineStateUnchanged) {
+  auto w1 = make_world();
+  (void)w1.run(9, 1.0);
+
+  auto w2 = make_world();
+  msim::NullSink none;
+  w2.run(9, 1.0, none);
+
+  EXPECT_EQ(w1.engine().book().best_bid(), w2.engine().book().best_bid());
+  EXPECT_EQ(w1.engine().book().best_ask(), w2.engine().book().best_ask());
+  for (const msim::Side s : {msim::Side::Buy, msim::Side::Sell}) {
+    const auto d1 = w1.engine().book().depth(s, 16);
+    const auto d2 = w2.engine().book().depth(s, 16);
+    ASSERT_EQ(d1.size(), d2.size());
+    for (std::size_t i = 0; i < d1.size(); ++i) {
+      EXPECT_EQ(d1[i].price, d2[i].price);
+      EXPECT_EQ(d1[i].total_qty, d2[i].total_qty);
+    }
+  }
+}
+
+TEST(ResultSinks, SimulatorStreamsRejectsAndTops) {
+  msim::Simulator sim;
+  std::vector<msim::Event> events;
+  events.push_back(msim::AddLimit{1, 10, msim::Side::Sell, 105, 5, 1});
+  events.push_back(msim::Cancel{99, 11}); // unknown id
+  events.push_back(msim::AddMarket{2, 12, msim::Side::Buy, 3, 9});
+
+  msim::MemorySink mem;
+  sim.run(events, mem);
+
+  ASSERT_EQ(mem.trades.size(), 1u);
+  EXPECT_EQ(mem.tops.size(), 3u);
+  ASSERT_EQ(mem.rejects.size(), 1u);
+  EXPECT_EQ(mem.rejects[0].id, 99u);
+  EXPECT_EQ(mem.rejects[0].type, msim::CommandType::Cancel);
+  EXPECT_EQ(mem.rejects[0].reason, msim::RejectReason::UnknownOrder);
+}
+
+TEST(ResultSinks, CsvSinkWritesOnlyRequestedStreams) {
+  const std::string prefix = ::testing::TempDir() + "msim_sink_";
+  std::remove((prefix + "top.csv").c_str());
+
+  msim::OrderFlowGenerator gen(3, msim::FlowParams{});
+  const auto events = gen.generate(0, 2.0);
+  {
+    msim::Simulator sim;
+    msim::CsvSink csv(prefix, msim::kSinkTrades | msim::kSinkRejects);
+    ASSERT_TRUE(csv.ok());
+    sim.run(events, csv);
+    EXPECT_EQ(csv.tops, 0u); // tops were never built
+    EXPECT_EQ(count_lines(prefix + "trades.csv"), csv.trades + 1);
+    EXPECT_EQ(count_lines(prefix + "rejects.csv"), csv.rejects + 1);
+  }
+  EXPECT_FALSE(std::ifstream(prefix + "top.csv").good());
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "msim/matching_engine.hpp"
+#include "msim/rule_pipeline.hpp"
+
+namespace {
+constexpr msim::Order limit(msim::Price px, msim::Qty q) {
+  return msim::Order{1, 1, msim::Side::Buy, msim::OrderType::Limit, px, q, 1};
+}
+
+constexpr msim::RejectReason reason_of(msim::RuleDecision d) { return d.reason; }
+
+using Grid4x100 = msim::StaticRulePipeline<4, 100, 200>;
+constexpr msim::RulesConfig kCfg{};
+} // namespace
+
+// Compile-time pipelines evaluate in constant expressions
+static_assert(Grid4x100::run(limit(104, 300), msim::MarketPhase::Continuous, kCfg).accept);
+static_assert(reason_of(Grid4x100::run(limit(102, 300), msim::MarketPhase::Continuous, kCfg)) ==
+              msim::RejectReason::PriceNotOnTick);
+static_assert(reason_of(Grid4x100::run(limit(104, 100), msim::MarketPhase::Continuous, kCfg)) ==
+              msim::RejectReason::QtyBelowMinimum);
+static_assert(reason_of(Grid4x100::run(limit(104, 250), msim::MarketPhase::Continuous, kCfg)) ==
+              msim::RejectReason::QtyNotOnLot);
+
+TEST(RulePipeline, StaticMatchesRuntimeForSameGrid) {
+  msim::RulesConfig cfg{};
+  cfg.tick_size_ticks = 5; // non power of two: modulo path
+  cfg.lot_size = 10;
+  cfg.min_qty = 20;
+  using Static = msim::StaticRulePipeline<5, 10, 20>;
+
+  for (msim::Price px = 95; px <= 110; ++px) {
+    for (msim::Qty q = -5; q <= 40; ++q) {
+      const auto o = limit(px, q);
+      const auto a = Static::run(o, msim::MarketPhase::Continuous, cfg);
+      const auto b = msim::RuntimeRulePipeline::run(o, msim::MarketPhase::Continuous, cfg);
+      EXPECT_EQ(a.accept, b.accept);
+      EXPECT_EQ(a.reason, b.reason);
+    }
+  }
+}
+
+TEST(RulePipeline, RuleSetUsesInstalledPipeline) {
+  msim::RulesConfig cfg{};
+  cfg.tick_size_ticks = 8;
+  cfg.enable_price_bands = false;
+  msim::RuleSet rules{cfg};
+  rules.use_pipeline<msim::StaticRulePipeline<8>>();
+
+  msim::MatchingEngine eng{rules};
+  auto bad = eng.process(msim::Order{1, 1, msim::Side::Sell, msim::OrderType::Limit, 1004, 1, 1});
+  EXPECT_EQ(bad.status, msim::OrderStatus::Rejected);
+  EXPECT_EQ(bad.reject_reason, msim::RejectReason::PriceNotOnTick);
+
+  // Market orders ignore the tick grid
+  auto mkt = eng.process(msim::Order{2, 2, msim::Side::Buy, msim::OrderType::Market, 3, 1, 2});
+  EXPECT_EQ(mkt.status, msim::OrderStatus::Accepted);
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "msim/command.hpp"
+#include "msim/matching_engine.hpp"
+#include "msim/stop_book.hpp"
+
+namespace {
+
+msim::Order limit(msim::OrderId id, msim::Ts ts, msim::Side s, msim::Price px, msim::Qty q, msim::OwnerId owner) {
+  return msim::Order{id, ts, s, msim::OrderType::Limit, px, q, owner};
+}
+
+msim::Order stop(msim::OrderId id, msim::Ts ts, msim::Side s, msim::Price trigger, msim::Qty q, msim::OwnerId owner) {
+  msim::Order o{id, ts, s, msim::OrderType::Market, 0, q, owner};
+  o.stop_price = trigger;
+  return o;
+}
+
+} // namespace
+
+TEST(StopBook, ElectsOnlyCrossedStopsNearestFirst) {
+  msim::StopBook sb;
+  EXPECT_TRUE(sb.add(stop(1, 1, msim::Side::Buy, 105, 1, 1)));
+  EXPECT_TRUE(sb.add(stop(2, 1, msim::Side::Buy, 103, 1, 1)));
+  EXPECT_TRUE(sb.add(stop(3, 1, msim::Side::Buy, 103, 1, 1)));
+  EXPECT_TRUE(sb.add(stop(4, 1, msim::Side::Buy, 110, 1, 1)));
+  EXPECT_TRUE(sb.add(stop(5, 1, msim::Side::Sell, 95, 1, 1)));
+  EXPECT_TRUE(sb.add(stop(6, 1, msim::Side::Sell, 99, 1, 1)));
+  EXPECT_FALSE(sb.add(stop(6, 1, msim::Side::Sell, 98, 1, 1)));
+
+  std::vector<msim::Order> out;
+  sb.elect(99, 105, out);
+  ASSERT_EQ(out.size(), 4u);
+  EXPECT_EQ(out[0].id, 2u); // buys lowest trigger first, FIFO within a price
+  EXPECT_EQ(out[1].id, 3u);
+  EXPECT_EQ(out[2].id, 1u);
+  EXPECT_EQ(out[3].id, 6u);
+  EXPECT_EQ(sb.size(), 2u);
+  EXPECT_TRUE(sb.contains(4));
+  EXPECT_TRUE(sb.contains(5));
+
+  msim::Order gone{};
+  EXPECT_TRUE(sb.cancel(5, gone));
+  EXPECT_EQ(gone.stop_price, 95);
+  EXPECT_FALSE(sb.cancel(5, gone));
+}
+
+TEST(StopOrders, BuyStopTriggersOnlyAtOrAboveStop) {
+  msim::MatchingEngine eng;
+  eng.enable_exec_reports();
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(limit(1, 1, msim::Side::Sell, 101, 5, 1), trades);
+  (void)eng.process(limit(2, 1, msim::Side::Sell, 103, 5, 1), trades);
+  (void)eng.process(stop(3, 2, msim::Side::Buy, 103, 2, 2), trades);
+  EXPECT_EQ(eng.stops().size(), 1u);
+
+  (void)eng.process(limit(4, 3, msim::Side::Buy, 101, 1, 3), trades); // prints 101
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(eng.stops().size(), 1u);
+
+  (void)eng.process(limit(5, 4, msim::Side::Buy, 103, 5, 3), trades); // sweeps 101 then 103
+  EXPECT_TRUE(eng.stops().empty());
+  ASSERT_EQ(trades.size(), 4u);
+  EXPECT_EQ(trades.back().taker_order_id, 3u);
+  EXPECT_EQ(trades.back().price, 103);
+  EXPECT_EQ(trades.back().qty, 2);
+
+  bool pending = false, triggered = false;
+  eng.exec_reports().drain([&](const msim::ExecReport& r) {
+    if (r.order_id != 3) return;
+    if (r.type == msim::ExecType::StopPending) pending = true;
+    if (r.type == msim::ExecType::Triggered) {
+      triggered = true;
+      EXPECT_EQ(r.price, 103);
+    }
+  });
+  EXPECT_TRUE(pending);
+  EXPECT_TRUE(triggered);
+}
+
+TEST(StopOrders, SellStopLimitRestsAfterElection) {
+  msim::MatchingEngine eng;
+  std::vector<msim::Trade> trades;
+
+  (void)eng.process(limit(1, 1, msim::Side::Buy, 99, 1, 1), trades);
+  msim::Order sl = limit(2, 1, msim::Side::Sell, 98, 4, 2);
+  sl.stop_price = 99;
+  (void)eng.process(sl, trades);
+  EXPECT_FALSE(eng.book().best_ask().has_value());
+
+  (void)eng.process(limit(3, 2, msim::Side::Sell, 99, 1, 3), trades); // prints 99
+  ASSERT_EQ(trades.size(), 1u);
+  ASSERT_TRUE(eng.book().best_ask().has_value());
+  EXPECT_EQ(*eng.book().best_ask(), 98);
+  EXPECT_EQ(eng.book().depth(msim::Side::Sell, 1)[0].total_qty, 4);
+}
+
+TEST(StopOrders, CascadeIsDeterministic) {
+  auto run = [] {
+    msim::MatchingEngine eng;
+    std::vector<msim::Trade> trades;
+    for (msim::OrderId i = 0; i < 5; ++i) {
+      (void)eng.process(limit(10 + i, 1, msim::Side::Buy, 100 - static_cast<msim::Price>(i), 1, 1), trades);
+    }
+    // Each stop's print walks the bid down and elects the next one
+    (void)eng.process(stop(20, 2, msim::Side::Sell, 100, 1, 2), trades);
+    (void)eng.process(stop(21, 2, msim::Side::Sell, 99, 1, 2), trades);
+    (void)eng.process(stop(22, 2, msim::Side::Sell, 98, 1, 2), trades);
+    (void)eng.process(stop(23, 2, msim::Side::Sell, 100, 1, 2), trades);
+    (void)eng.process(msim::Order{30, 3, msim::Side::Sell, msim::OrderType::Market, 0, 1, 3}, trades);
+    EXPECT_TRUE(eng.stops().empty());
+    return trades;
+  };
+
+  const auto a = run();
+  const auto b = run();
+  ASSERT_EQ(a.size(), 5u);
+  ASSERT_EQ(a.size(), b.size());
+  const std::vector<msim::OrderId> takers{30, 20, 23, 21, 22};
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(a[i].taker_order_id, takers[i]);
+    EXPECT_EQ(a[i].price, 100 - static_cast<msim::Price>(i));
+    EXPECT_EQ(a[i].taker_order_id, b[i].taker_order_id);
+    EXPECT_EQ(a[i].id, b[i].id);
+  }
+}
+
+TEST(StopOrders, PendingStopCancelsThroughBatch) {
+  msim::MatchingEngine eng;
+  eng.enable_exec_reports();
+  std::vector<msim::Trade> trades;
+
+  const std::vector<msim::Command> cmds{
+      msim::Command::submit(stop(1, 1, msim::Side::Buy, 105, 2, 1)),
+      msim::Command::modify(1, 1, 2), // only cancels reach pending stops
+      msim::Command::cancel(1, 3),
+      msim::Command::cancel(1, 4),
+  };
+  std::vector<msim::ProcessStatus> st;
+  eng.process_batch(cmds, trades, [&](const msim::Command&, const msim::ProcessStatus& s, auto) { st.push_back(s); });
+
+  ASSERT_EQ(st.size(), 4u);
+  EXPECT_EQ(st[0].status, msim::OrderStatus::Accepted);
+  EXPECT_EQ(st[1].status, msim::OrderStatus::Rejected);
+  EXPECT_EQ(st[2].status, msim::OrderStatus::Accepted);
+  EXPECT_EQ(st[3].status, msim::OrderStatus::Rejected);
+  EXPECT_TRUE(eng.stops().empty());
+}